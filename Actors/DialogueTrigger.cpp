@@ -1,6 +1,8 @@
 #include "vpch.h"
 #include "DialogueTrigger.h"
 #include "Components/BoxTriggerComponent.h"
+#include "Gameplay/Game/TriggerBroadphase.h"
+#include "Gameplay/Game/DialogueCache.h"
 #include "Actors/Game/Player.h"
 
 DialogueTrigger::DialogueTrigger()
@@ -9,25 +11,22 @@ DialogueTrigger::DialogueTrigger()
     rootComponent = boxTriggerComponent;
 }
 
-void DialogueTrigger::Start()
+DialogueTrigger::~DialogueTrigger()
 {
-    boxTriggerComponent->SetTargetAsPlayer();
+    TriggerBroadphase::RemoveOwnedBy(this);
 }
 
-void DialogueTrigger::Tick(float deltaTime)
+void DialogueTrigger::Start()
 {
-    if (dialogueCurrentlyPlaying) return;
+    boxTriggerComponent->SetTargetAsPlayer();
 
-    if (boxTriggerComponent->ContainsTarget())
+    //Unconfigured triggers would only cache a failed load.
+    if (!dialogueFile.empty())
     {
-        Player* player = Player::system.GetFirstActor();
-        if (player)
-        {
-            player->StartDialogue(dialogueFile);
-
-            dialogueCurrentlyPlaying = true;
-        }
+        DialogueCache::Prefetch(dialogueFile);
     }
+
+    TriggerBroadphase::Add(boxTriggerComponent, [this]() { PlayerEnteredTrigger(); });
 }
 
 Properties DialogueTrigger::GetProps()
@@ -36,3 +35,16 @@ Properties DialogueTrigger::GetProps()
     props.Add("Dialogue File", &dialogueFile).autoCompletePath = "/Dialogue/";
     return props;
 }
+
+void DialogueTrigger::PlayerEnteredTrigger()
+{
+    if (dialogueCurrentlyPlaying) return;
+
+    Player* player = Player::system.GetFirstActor();
+    if (player)
+    {
+        player->StartDialogue(dialogueFile);
+
+        dialogueCurrentlyPlaying = true;
+    }
+}
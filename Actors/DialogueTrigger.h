@@ -11,11 +11,13 @@ public:
 	ACTOR_SYSTEM(DialogueTrigger);
 
 	DialogueTrigger();
+	~DialogueTrigger();
 	virtual void Start() override;
-	virtual void Tick(float deltaTime) override;
 	virtual Properties GetProps() override;
 
 private:
+	void PlayerEnteredTrigger();
+
 	BoxTriggerComponent* boxTriggerComponent = nullptr;
 
 	std::string dialogueFile;
@@ -1,6 +1,8 @@
 #include "vpch.h"
 #include "Door.h"
 #include "Components/MeshComponent.h"
+#include "Gameplay/Game/OccupancyGrid.h"
+#include "Gameplay/Game/ActorRef.h"
 
 Door::Door()
 {
@@ -8,6 +10,12 @@ Door::Door()
     rootComponent = mesh;
 }
 
+Door::~Door()
+{
+    //DoorSwitches link to doors through ActorRefs.
+    ActorRefs::NotifyDestroyed(this);
+}
+
 Properties Door::GetProps()
 {
     Properties props = __super::GetProps();
@@ -19,4 +27,14 @@ void Door::Open()
 {
     isOpen = true;
     mesh->active = false;
+
+    OccupancyGrid::OpenDoor(mesh);
+}
+
+void Door::Close()
+{
+    isOpen = false;
+    mesh->active = true;
+
+    OccupancyGrid::CloseDoor(mesh);
 }
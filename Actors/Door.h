@@ -11,9 +11,13 @@ public:
 	ACTOR_SYSTEM(Door);
 
 	Door();
+	~Door();
 	virtual Properties GetProps() override;
 
 	void Open();
+	//Only used to put a door back as a save had it, nothing in a level closes doors.
+	void Close();
+	bool IsOpen() const { return isOpen; }
 
 private:
 	MeshComponent* mesh = nullptr;
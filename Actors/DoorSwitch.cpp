@@ -1,27 +1,28 @@
 #include "vpch.h"
 #include "DoorSwitch.h"
-#include "Actors/Game/Door.h"
+
+void DoorSwitch::Start()
+{
+	__super::Start();
+
+	ActorRefs::Register(&linkedDoor);
+}
 
 Properties DoorSwitch::GetProps()
 {
 	Properties props = __super::GetProps();
-	props.Add("Door Name", &linkedDoorName);
+	props.Add("Door Name", &linkedDoor.actorName);
 	return props;
 }
 
 void DoorSwitch::Interact()
 {
-	Actor* linkedDoor = World::GetActorByNameAllowNull(linkedDoorName);
-	if (linkedDoor)
+	Door* door = linkedDoor.Get();
+	if (door)
 	{
-		Door* door = dynamic_cast<Door*>(linkedDoor);
-		if (door)
-		{
-			door->Open();
-		}
-
+		door->Open();
 		return;
 	}
 
-	Log("[%s] door not found on Interact for [%s]", linkedDoorName.c_str(), GetName().c_str());
+	Log("[%s] door not found on Interact for [%s]", linkedDoor.actorName.c_str(), GetName().c_str());
 }
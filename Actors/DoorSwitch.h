@@ -1,6 +1,8 @@
 #pragma once
 
 #include "InteractActor.h"
+#include "Door.h"
+#include "Gameplay/Game/ActorRef.h"
 
 class DoorSwitch : public InteractActor
 {
@@ -8,9 +10,10 @@ public:
 	ACTOR_SYSTEM(DoorSwitch);
 
 	DoorSwitch() {}
+	virtual void Start() override;
 	virtual Properties GetProps() override;
 	virtual void Interact() override;
 
 private:
-	std::string linkedDoorName;
+	ActorRef<Door> linkedDoor;
 };
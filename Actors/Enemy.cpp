@@ -2,10 +2,20 @@
 #include "Enemy.h"
 #include "Components/BoxTriggerComponent.h"
 #include "Components/MeshComponent.h"
-#include "Components/WidgetComponent.h"
 #include "UI/Game/EnemyHealthWidget.h"
 #include "Gameplay/GameUtils.h"
 #include "Gameplay/CombatManager.h"
+#include "Gameplay/Game/EnemySimulation.h"
+#include "Gameplay/Game/ActorRef.h"
+#include "Gameplay/Game/JobSystem.h"
+#include "Gameplay/Game/GridPathfinder.h"
+#include "Gameplay/Game/FlowField.h"
+#include "Gameplay/Game/OccupancyGrid.h"
+#include "Gameplay/Game/Profiler.h"
+#include "Gameplay/Game/WorldWidgets.h"
+
+//Reused between turns so planning a move doesn't allocate.
+std::vector<XMINT3> combatTurnPath;
 
 Enemy::Enemy()
 {
@@ -15,38 +25,112 @@ Enemy::Enemy()
 	rootComponent = mesh;
 	rootComponent->AddChild(aggroTrigger);
 
-	healthWidget = CreateComponent(WidgetComponent(), "HealthWidget");
-	healthWidget->CreateWidget<EnemyHealthWidget>();
+	healthWidget = CreateWidget<EnemyHealthWidget>();
 }
 
-void Enemy::Start()
+Enemy::~Enemy()
 {
-	aggroTrigger->SetTargetAsPlayer();
+	//These do nothing if death already took it out. Destroys only run at sync points, never while
+	//EnemySimulation's chunks are ticking.
+	EnemySimulation::Remove(this);
+	WorldWidgets::RemoveAnchoredTo(this);
+	ActorRefs::NotifyDestroyed(this);
 }
 
-void Enemy::Tick(float deltaTime)
+void Enemy::Start()
 {
-	healthWidget->SetPosition(GetHomogeneousPositionV());
-	healthWidget->GetWidget<EnemyHealthWidget>()->healthPoints = healthPoints;
+	aggroTrigger->SetTargetAsPlayer();
 
-	if (aggroTrigger->ContainsTarget() && !inCombat)
-	{
-		PlayerEnteredAggroTrigger();
-	}
+	EnemySimulation::Add(this);
+
+	//Stays hidden until combat starts.
+	WorldWidgets::Add(healthWidget, this, HEALTH_WIDGET_MAX_DISTANCE);
 }
 
 Properties Enemy::GetProps()
 {
-	return __super::GetProps();
+	Properties props = __super::GetProps();
+	props.Add("Action Points", &actionPoints);
+	return props;
 }
 
 void Enemy::InflictDamage(int damageAmount)
 {
-	healthPoints -= damageAmount;
-	if (healthPoints <= 0)
+	//Already dead and waiting on Destroy().
+	if (simulationIndex < 0) return;
+
+	if (EnemySimulation::InflictDamage(this, damageAmount) <= 0)
+	{
+		EnemySimulation::Remove(this);
+		WorldWidgets::Remove(healthWidget);
+		ActorRefs::NotifyDestroyed(this);
+		JobSystem::Defer([this]() { Destroy(); });
+	}
+}
+
+void Enemy::TakeCombatTurn(XMINT3 targetCell)
+{
+	PROFILE_FUNCTION();
+
+	if (!inCombat || simulationIndex < 0) return;
+
+	const XMINT3 currentCell = OccupancyGrid::PositionToCell(GetPositionV());
+
+	//Cells this turn's movement passes through, in order.
+	combatTurnPath.clear();
+
+	//Every enemy in combat shares the one field toward the player. A* is only for enemies
+	//too far away for the field to reach.
+	if (FlowField::IsCovered(currentCell))
+	{
+		XMINT3 cell = currentCell;
+		for (int step = 0; step < actionPoints; step++)
+		{
+			XMINT3 nextCell;
+			if (!FlowField::GetNextCell(cell, nextCell)) break;
+
+			//Stop next to the target rather than on top of it.
+			if (nextCell.x == targetCell.x && nextCell.y == targetCell.y && nextCell.z == targetCell.z) break;
+
+			combatTurnPath.push_back(nextCell);
+			cell = nextCell;
+		}
+	}
+	else
+	{
+		const GridPathfinder::PathResult& result = GridPathfinder::FindPath(currentCell, targetCell, actionPoints);
+
+		size_t stepCount = result.path.size();
+		if (result.reachedGoal && stepCount > 0)
+		{
+			stepCount--;
+		}
+
+		combatTurnPath.assign(result.path.begin(), result.path.begin() + stepCount);
+	}
+
+	//Enemies can pass through each other but not end up on the same cell. Back off along the path
+	//to the furthest cell no other enemy has already taken this turn.
+	XMINT3 destinationCell = currentCell;
+	for (size_t i = combatTurnPath.size(); i > 0; i--)
+	{
+		if (!EnemySimulation::IsCellReserved(combatTurnPath[i - 1]))
+		{
+			destinationCell = combatTurnPath[i - 1];
+			break;
+		}
+	}
+
+	if (destinationCell.x == currentCell.x && destinationCell.y == currentCell.y && destinationCell.z == currentCell.z)
 	{
-		Destroy();
+		return;
 	}
+
+	EnemySimulation::MoveCellReservation(currentCell, destinationCell);
+
+	const XMVECTOR newPos = OccupancyGrid::CellToPosition(destinationCell);
+	SetPosition(newPos);
+	EnemySimulation::SetPosition(this, newPos);
 }
 
 void Enemy::PlayerEnteredAggroTrigger()
@@ -58,7 +142,7 @@ void Enemy::PlayerEnteredAggroTrigger()
 
 	aggroTrigger->renderWireframeColour = XMFLOAT4(1.f, 0.f, 0.f, 1.f); //Set trigger to red.
 
-	healthWidget->AddToViewport();
+	WorldWidgets::SetShown(healthWidget, true);
 
 	CombatManager::AddActiveEnemy(this);
 }
@@ -6,7 +6,6 @@
 struct BoxTriggerComponent;
 struct MeshComponent;
 class EnemyHealthWidget;
-struct WidgetComponent;
 
 class Enemy : public Actor
 {
@@ -14,13 +13,25 @@ public:
 	ACTOR_SYSTEM(Enemy);
 
 	Enemy();
+	~Enemy();
 	virtual void Start() override;
-	virtual void Tick(float deltaTime) override;
 	virtual Properties GetProps() override;
 
 	void InflictDamage(int damageAmount);
 
+	//Spends this turn's action points moving toward targetCell. Does nothing out of combat.
+	//Expects FlowField to have been updated toward targetCell for the turn.
+	void TakeCombatTurn(XMINT3 targetCell);
+
+	static const int START_HEALTH_POINTS = 3;
+
+	//Past this the health bar is culled even while in combat.
+	static constexpr float HEALTH_WIDGET_MAX_DISTANCE = 40.f;
+
 private:
+	//Health, combat state and aggro checks live in EnemySimulation's arrays.
+	friend class EnemySimulation;
+
 	void PlayerEnteredAggroTrigger();
 
 	//Trigger that shows the enemy's aggro field.
@@ -28,9 +39,12 @@ private:
 
 	MeshComponent* mesh = nullptr;
 
-	WidgetComponent* healthWidget = nullptr;
+	//Placed by WorldWidgets, not a WidgetComponent, so the engine never projects it as well.
+	EnemyHealthWidget* healthWidget = nullptr;
+
+	int simulationIndex = -1;
 
-	int healthPoints = 3;
+	int actionPoints = 3;
 
 	bool inCombat = false;
 };
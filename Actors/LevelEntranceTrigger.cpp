@@ -1,11 +1,13 @@
 #include "vpch.h"
 #include "LevelEntranceTrigger.h"
-#include "Input.h"
 #include "VString.h"
-#include "FileSystem.h"
 #include "Components/BoxTriggerComponent.h"
 #include "Actors/Game/PlayerShip.h"
 #include "UI/Game/LevelEntranceWidget.h"
+#include "Gameplay/Game/TriggerBroadphase.h"
+#include "Gameplay/Game/LevelLoader.h"
+#include "Gameplay/Game/GameInput.h"
+#include "Gameplay/Game/OverworldStreaming.h"
 
 LevelEntranceTrigger::LevelEntranceTrigger()
 {
@@ -13,28 +15,32 @@ LevelEntranceTrigger::LevelEntranceTrigger()
 	rootComponent = boxTriggerComponent;
 }
 
+LevelEntranceTrigger::~LevelEntranceTrigger()
+{
+	TriggerBroadphase::RemoveOwnedBy(this);
+}
+
 void LevelEntranceTrigger::Start()
 {
-	boxTriggerComponent->targetActor = PlayerShip::system.GetActors()[0];
+	boxTriggerComponent->targetActor = PlayerShip::system.GetFirstActor();
 
 	levelEntranceWidget = CreateWidget<LevelEntranceWidget>();
 	levelEntranceWidget->levelName = levelName;
+
+	//Streaming may have already dropped this entrance's chunk if the ship started first.
+	if (isStreamedIn)
+	{
+		AddToTriggerBroadphase();
+	}
 }
 
 void LevelEntranceTrigger::Tick(float deltaTime)
 {
-	if (boxTriggerComponent->ContainsTarget())
-	{
-		levelEntranceWidget->AddToViewport();
+	if (OverworldStreaming::IsStreamedOut(this)) return;
 
-		if (Input::GetKeyDown(Keys::Enter))
-		{
-			FileSystem::LoadWorld(VString::wstos(levelName));
-		}
-	}
-	else
+	if (playerShipInTrigger && GameInput::GetKeyDown(Keys::Enter))
 	{
-		levelEntranceWidget->RemoveFromViewport();
+		LevelLoader::RequestLoad(VString::wstos(levelName));
 	}
 }
 
@@ -44,3 +50,44 @@ Properties LevelEntranceTrigger::GetProps()
 	props.Add("Level Name", &levelName);
 	return props;
 }
+
+void LevelEntranceTrigger::SetStreamedIn(bool streamedIn)
+{
+	if (streamedIn == isStreamedIn) return;
+	isStreamedIn = streamedIn;
+
+	if (isStreamedIn)
+	{
+		AddToTriggerBroadphase();
+	}
+	else
+	{
+		TriggerBroadphase::Remove(boxTriggerComponent);
+		if (playerShipInTrigger)
+		{
+			PlayerShipExitedTrigger();
+		}
+	}
+}
+
+void LevelEntranceTrigger::AddToTriggerBroadphase()
+{
+	TriggerBroadphase::Add(boxTriggerComponent,
+		[this]() { PlayerShipEnteredTrigger(); },
+		[this]() { PlayerShipExitedTrigger(); });
+}
+
+void LevelEntranceTrigger::PlayerShipEnteredTrigger()
+{
+	playerShipInTrigger = true;
+	levelEntranceWidget->AddToViewport();
+
+	//The ship usually sits in the trigger for a while before entering, warm the level's file in the meantime.
+	LevelLoader::WarmFileCache(VString::wstos(levelName));
+}
+
+void LevelEntranceTrigger::PlayerShipExitedTrigger()
+{
+	playerShipInTrigger = false;
+	levelEntranceWidget->RemoveFromViewport();
+}
@@ -13,14 +13,25 @@ public:
 	ACTOR_SYSTEM(LevelEntranceTrigger);
 
 	LevelEntranceTrigger();
+	~LevelEntranceTrigger();
 	virtual void Start() override;
 	virtual void Tick(float deltaTime) override;
 	virtual Properties GetProps() override;
 
+	//Set by OverworldStreaming as this entrance's chunk streams in and out.
+	void SetStreamedIn(bool streamedIn);
+
 private:
+	void AddToTriggerBroadphase();
+	void PlayerShipEnteredTrigger();
+	void PlayerShipExitedTrigger();
+
 	BoxTriggerComponent* boxTriggerComponent = nullptr;
 
 	LevelEntranceWidget* levelEntranceWidget = nullptr;
 
 	std::wstring levelName;
+
+	bool playerShipInTrigger = false;
+	bool isStreamedIn = true;
 };
@@ -3,6 +3,11 @@
 #include "Components/EmptyComponent.h"
 #include "Components/WidgetComponent.h"
 #include "UI/Game/NoteWidget.h"
+#include "Gameplay/Game/WorldWidgets.h"
+#include "Gameplay/Game/NotePool.h"
+
+//Notes are only readable up close, no point drawing the ones across the level.
+const float noteWidgetMaxDistance = 25.f;
 
 NoteActor::NoteActor()
 {
@@ -11,18 +16,29 @@ NoteActor::NoteActor()
     noteWidget = CreateWidget<NoteWidget>();
 }
 
+NoteActor::~NoteActor()
+{
+    WorldWidgets::RemoveAnchoredTo(this);
+    NotePool::NotifyDestroyed(this);
+}
+
 Properties NoteActor::GetProps()
 {
     return __super::GetProps();
 }
 
-void NoteActor::SetNoteText(std::wstring noteText)
+void NoteActor::SetNoteText(const wchar_t* noteText, int length)
 {
-    noteWidget->noteText = noteText;
+    noteWidget->SetNoteText(noteText, length);
 }
 
 void NoteActor::AddNoteWidgetToViewport()
 {
-    noteWidget->AddToViewport();
-    noteWidget->pos = GetHomogeneousPositionV();
+    WorldWidgets::Add(noteWidget, this, noteWidgetMaxDistance);
+    WorldWidgets::SetShown(noteWidget, true);
+}
+
+void NoteActor::RemoveNoteWidgetFromViewport()
+{
+    WorldWidgets::Remove(noteWidget);
 }
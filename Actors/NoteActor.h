@@ -5,17 +5,20 @@
 
 struct NoteWidget;
 
-//3D notes placed in world by player.
+//3D notes placed in world by player. Pooled and placed through NotePool rather than added directly.
 class NoteActor : public Actor
 {
 public:
 	ACTOR_SYSTEM(NoteActor);
 
 	NoteActor();
+	~NoteActor();
 	virtual Properties GetProps() override;
 
-	void SetNoteText(std::wstring noteText);
+	//Copies the text into the widget, which keeps its buffer between reuses.
+	void SetNoteText(const wchar_t* noteText, int length);
 	void AddNoteWidgetToViewport();
+	void RemoveNoteWidgetFromViewport();
 
 private:
 	NoteWidget* noteWidget = nullptr;
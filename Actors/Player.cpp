@@ -1,33 +1,56 @@
 #include "vpch.h"
 #include "Player.h"
-#include <limits>
-#include <array>
-#include "Input.h"
+#include <algorithm>
 #include "VMath.h"
-#include "Actors/Game/NoteActor.h"
 #include "Actors/Game/InteractActor.h"
 #include "Actors/Game/Enemy.h"
 #include "Components/CameraComponent.h"
 #include "Components/EmptyComponent.h"
 #include "Components/Game/PhotoComponent.h"
-#include "Physics/Raycast.h"
 #include "Render/Renderer.h"
 #include "UI/Game/ScanWidget.h"
 #include "UI/Game/PhotoWidget.h"
 #include "UI/Game/SalvageMissionWidget.h"
 #include "UI/Game/DialogueWidget.h"
 #include "UI/Game/PlayerActionBarWidget.h"
+#include "UI/Game/UIDrawListWidget.h"
 #include "Gameplay/GameUtils.h"
-#include "Gameplay/GameInstance.h"
-#include "Gameplay/DialogueStructures.h"
 #include "Gameplay/CombatManager.h"
+#include "Gameplay/Game/OccupancyGrid.h"
+#include "Gameplay/Game/RaycastBatch.h"
+#include "Gameplay/Game/TriggerBroadphase.h"
+#include "Gameplay/Game/DialogueCache.h"
+#include "Gameplay/Game/PhotoFilmRoll.h"
+#include "Gameplay/Game/PhotoTags.h"
+#include "Gameplay/Game/EnemySimulation.h"
+#include "Gameplay/Game/JobSystem.h"
+#include "Gameplay/Game/FlowField.h"
+#include "Gameplay/Game/GameInput.h"
+#include "Gameplay/Game/Profiler.h"
+#include "Gameplay/Game/SaveSnapshot.h"
+#include "Gameplay/Game/ScanVisor.h"
+#include "Gameplay/Game/CubeOrientation.h"
+#include "Gameplay/Game/FixedTimestep.h"
+#include "Gameplay/Game/WorldWidgets.h"
+#include "Gameplay/Game/NotePool.h"
+#include "Gameplay/Game/DebugCommands.h"
 
 const int movementIncrement = 1;
 
-int photoFilenameIndex = 0;
-std::array<std::wstring, 5> photoFilenames;
+const std::string quickSaveFilename = "QuickSave.sav";
 
-Dialogue dialogue;
+PhotoFilmRoll filmRoll;
+
+FixedTimestep playerTimestep;
+InterpolatedTransform playerSimTransform;
+ScanVisor scanVisor;
+
+//All of the Player's camera facing queries share the same ray, only their distances differ.
+//It is cast once per frame on first use and each query checks the hit distance against its own.
+RaycastBatch cameraRayBatch;
+const float maxCameraRayDistance = 100.f;
+
+std::shared_ptr<const CompiledDialogue> dialogue;
 int dialogueCurrentLine = 0;
 
 Player::Player()
@@ -36,26 +59,69 @@ Player::Player()
 
 	camera = CreateComponent(CameraComponent(), "Camera");
 	rootComponent->AddChild(camera);
+}
 
-	photoFilenames[0] = L"photo0.jpg";
-	photoFilenames[1] = L"photo1.jpg";
-	photoFilenames[2] = L"photo2.jpg";
-	photoFilenames[3] = L"photo3.jpg";
-	photoFilenames[4] = L"photo4.jpg";
+//Exiting the game from a level never goes through LevelLoader, so the recording is closed here too.
+Player::~Player()
+{
+	GameInput::StopRecording();
 }
 
 void Player::Start()
 {
 	CreatePlayerWidgets();
 
-	nextPos = GetPositionV();
-	nextRot = GetRotationV();
+	OccupancyGrid::Build();
+
+#ifdef _DEBUG
+	const int gridMismatches = OccupancyGrid::ValidateAgainstRaycasts(this);
+	if (gridMismatches > 0)
+	{
+		Log("Occupancy grid disagrees with raycasts in %d places.", gridMismatches);
+	}
+#endif
+
+	filmRoll.Load(filmExposureCount);
+	filmRoll.onRollFinished = []() { Log("Last photo on film roll taken."); };
+
+	NotePool::Init(maxNotes);
+
+	gridPosition = OccupancyGrid::PositionToCell(GetPositionV());
+	gridOrientation = CubeOrientations::FromQuaternion(GetRotationV());
+	nextPos = OccupancyGrid::CellToPosition(gridPosition);
+	nextRot = CubeOrientations::ToQuaternion(gridOrientation);
+
+	playerTimestep.tickRate = std::max(simTickRate, minFixedTickRate);
+	playerTimestep.Reset();
+	playerSimTransform.Reset(GetPositionV(), GetRotationV());
+
+	if (!inputReplayFile.empty())
+	{
+		GameInput::StartReplay(inputReplayFile);
+	}
+	else if (!inputRecordFile.empty())
+	{
+		GameInput::StartRecording(inputRecordFile, playerTimestep.tickRate);
+	}
+
+	if (profileCaptureFrames > 0)
+	{
+		PROFILE_START_CAPTURE("ProfileCapture.json", profileCaptureFrames);
+	}
 }
 
 void Player::Tick(float deltaTime)
 {
+	deltaTime = GameInput::BeginFrame(deltaTime, camera);
+
+	PROFILE_FRAME();
+	PROFILE_FUNCTION();
+
 	camera->upViewVector = GetUpVectorV();
 
+	RaycastBatch::InvalidateSceneBoxes();
+	cameraRayBatch.Reset();
+
 	if (inCombat)
 	{
 		actionBarWidget->actionPoints = combatActionPoints;
@@ -74,17 +140,111 @@ void Player::Tick(float deltaTime)
 
 	ToggleSalvageMissionStats();
 
+	QuickSaveInput();
+
+	EndCombatTurn();
+
 	TakePhoto();
 
 	SpawnNote();
 
-	SetPosition(VMath::VectorConstantLerp(GetPositionV(), nextPos, deltaTime, moveSpeed));
-	SetRotation(VMath::QuatConstantLerp(GetRotationV(), nextRot, deltaTime, rotSpeed));
+	DebugCommandInput();
+
+	const int stepCount = GameInput::AdvanceTimestep(playerTimestep, deltaTime);
+	for (int i = 0; i < stepCount; i++)
+	{
+		SimulateMovementStep(playerTimestep.GetStepTime());
+	}
+
+	const float alpha = playerTimestep.GetAlpha();
+	SetPosition(playerSimTransform.GetInterpolatedPosition(alpha));
+	SetRotation(playerSimTransform.GetInterpolatedRotation(alpha));
+
+	TriggerBroadphase::UpdateTarget(this);
+
+	//Sync point for world changes queued up during the frame. Enemies killed this frame are gone
+	//before the simulation looks at them.
+	JobSystem::FlushDeferred();
+
+	//After the flush so notes spawned this frame are placed along with the rest.
+	NotePool::Update(GetPositionV());
+
+	//Enemy checks and widget culling share no data, so they run at the same time. Their results
+	//are applied in this order so enemies entering aggro this frame get their health bar shown.
+	WorldWidgets::GatherAnchors();
+	JobSystem::RunSystemTasks({
+		EnemySimulation::GetTickTask(playerSimTransform.GetPosition()),
+		WorldWidgets::GetCullTask(WorldWidgets::GetCameraView(camera)),
+	});
+	EnemySimulation::ApplyTick();
+	WorldWidgets::ApplyCull();
+
+	//Last, after everything above that adds widgets to the viewport.
+	uiDrawListWidget->BeginFrame();
+}
+
+void Player::SimulateMovementStep(float stepTime)
+{
+	playerSimTransform.Push(
+		VMath::VectorConstantLerp(playerSimTransform.GetPosition(), nextPos, stepTime, moveSpeed),
+		VMath::QuatConstantLerp(playerSimTransform.GetRotation(), nextRot, stepTime, rotSpeed));
 }
 
 Properties Player::GetProps()
 {
-    return __super::GetProps();
+	Properties props = __super::GetProps();
+	props.Add("Film Exposures", &filmExposureCount);
+	props.Add("Sim Tick Rate", &simTickRate);
+	props.Add("Record Input File", &inputRecordFile);
+	props.Add("Replay Input File", &inputReplayFile);
+	props.Add("Profile Capture Frames", &profileCaptureFrames);
+	props.Add("Max Notes", &maxNotes);
+	return props;
+}
+
+//Saves where the Player is headed rather than mid-lerp so restores land on the grid.
+void Player::WriteSaveState(PlayerSaveState& state) const
+{
+	XMStoreFloat3(&state.position, nextPos);
+	XMStoreFloat4(&state.rotation, nextRot);
+	state.combatActionPoints = combatActionPoints;
+	state.filmExposuresTaken = filmRoll.GetExposuresTaken();
+}
+
+void Player::ReadSaveState(const PlayerSaveState& state)
+{
+	gridPosition = OccupancyGrid::PositionToCell(XMLoadFloat3(&state.position));
+	gridOrientation = CubeOrientations::FromQuaternion(XMLoadFloat4(&state.rotation));
+	nextPos = OccupancyGrid::CellToPosition(gridPosition);
+	nextRot = CubeOrientations::ToQuaternion(gridOrientation);
+	SetPosition(nextPos);
+	SetRotation(nextRot);
+	playerSimTransform.Reset(nextPos, nextRot);
+
+	combatActionPoints = state.combatActionPoints;
+	filmRoll.SetExposuresTaken(state.filmExposuresTaken);
+}
+
+void Player::DebugCommandInput()
+{
+#ifndef GAME_SHIPPING
+	if (GameInput::GetKeyDown(Keys::F10))
+	{
+		DebugCommands::RunAll();
+	}
+#endif
+}
+
+void Player::QuickSaveInput()
+{
+	if (GameInput::GetKeyDown(Keys::F5))
+	{
+		SaveSnapshot::Save(this, quickSaveFilename);
+	}
+	else if (GameInput::GetKeyDown(Keys::F9))
+	{
+		SaveSnapshot::Load(this, quickSaveFilename);
+	}
 }
 
 //@Todo: move all dialogue code somewhere else
@@ -92,14 +252,11 @@ void Player::StartDialogue(std::string dialogueFilename)
 {
 	dialogueWidget->AddToViewport();
 
-	dialogue.Reset();
-	dialogue.filename = dialogueFilename;
-	dialogue.LoadFromFile();
+	dialogue = DialogueCache::Get(dialogueFilename);
 
-	auto foundLineIt = dialogue.data.find(dialogueCurrentLine);
-	if (foundLineIt != dialogue.data.end())
+	if (dialogue->HasLine(dialogueCurrentLine))
 	{
-		dialogueWidget->dialogueText = foundLineIt->second.text;
+		dialogueWidget->SetDialogueText(dialogue->GetLineText(dialogueCurrentLine));
 
 		dialogueCurrentLine++;
 	}
@@ -119,12 +276,13 @@ void Player::SetInCombat(bool combatActive)
 
 void Player::ProgressDialogue()
 {
-	if (Input::GetKeyDown(Keys::Down))
+	PROFILE_FUNCTION();
+
+	if (GameInput::GetKeyDown(Keys::Down))
 	{
-		auto foundLineIt = dialogue.data.find(dialogueCurrentLine);
-		if (foundLineIt != dialogue.data.end())
+		if (dialogue && dialogue->HasLine(dialogueCurrentLine))
 		{
-			dialogueWidget->dialogueText = foundLineIt->second.text;
+			dialogueWidget->SetDialogueText(dialogue->GetLineText(dialogueCurrentLine));
 
 			dialogueCurrentLine++;
 		}
@@ -137,10 +295,14 @@ void Player::ProgressDialogue()
 
 void Player::EndDialogue()
 {
-	Log("Dialouge [%s] ended", dialogue.filename.c_str());
+	if (dialogue)
+	{
+		Log("Dialouge [%s] ended", dialogue->filename.c_str());
+	}
+
 	dialogueWidget->RemoveFromViewport();
 	dialogueCurrentLine = 0;
-	dialogue.Reset();
+	dialogue.reset();
 }
 
 bool Player::CombatMoveCheck()
@@ -162,12 +324,22 @@ bool Player::CombatMoveCheck()
 
 void Player::EndCombatTurn()
 {
+	PROFILE_FUNCTION();
+
 	if (inCombat)
 	{
-		if (Input::GetKeyDown(Keys::Space))
+		if (GameInput::GetKeyDown(Keys::Space))
 		{
 			combatActionPoints = MAX_ACTION_POINTS;
 
+			FlowField::Update(gridPosition);
+			EnemySimulation::BeginCombatTurn(gridPosition);
+
+			for (auto& enemy : Enemy::system.GetActors())
+			{
+				enemy->TakeCombatTurn(gridPosition);
+			}
+
 			CombatManager::ChangeToEnemyTurn();
 		}
 	}
@@ -175,6 +347,8 @@ void Player::EndCombatTurn()
 
 void Player::MovementInput(float deltaTime)
 {
+	PROFILE_FUNCTION();
+
 	if (CheckIfPlayerMovementAndRotationStopped())
 	{
 		if (shakeOnWallRotateEnd)
@@ -183,150 +357,136 @@ void Player::MovementInput(float deltaTime)
 			shakeOnWallRotateEnd = false;
 		}
 
-		XMVECTOR previousPos = GetPositionV();
-
-		if (Input::GetKeyHeld(Keys::W))
+		if (GameInput::GetKeyHeld(Keys::W))
 		{
-			if (!RotatePlayerOnWallMoveHit(rightAxis, forwardAxis, -90.f, -90.f, 90.f, 90.f))
+			if (!RotatePlayerOnWallMoveHit(rightAxis, forwardAxis,
+				WorldTurn::NegativeX, WorldTurn::NegativeZ, WorldTurn::PositiveX, WorldTurn::PositiveZ))
 			{
 				if (CombatMoveCheck())
 				{
-					nextPos = GetPositionV() + (forwardAxis * movementIncrement);
-
-					if (IsFloorEmptyOnNextMove())
-					{
-						nextPos = previousPos;
-					}
+					MoveToCell(StepCell(gridPosition, forwardAxis, movementIncrement));
 				}
 			}
 		}
-		else if (Input::GetKeyHeld(Keys::S))
+		else if (GameInput::GetKeyHeld(Keys::S))
 		{
-			if (!RotatePlayerOnWallMoveHit(rightAxis, -forwardAxis, 90.f, 90.f, -90.f, -90.f))
+			if (!RotatePlayerOnWallMoveHit(rightAxis, -forwardAxis,
+				WorldTurn::PositiveX, WorldTurn::PositiveZ, WorldTurn::NegativeX, WorldTurn::NegativeZ))
 			{
 				if (CombatMoveCheck())
 				{
-					nextPos = GetPositionV() - (forwardAxis * movementIncrement);
-
-					if (IsFloorEmptyOnNextMove())
-					{
-						nextPos = previousPos;
-					}
+					MoveToCell(StepCell(gridPosition, -forwardAxis, movementIncrement));
 				}
 			}
 		}
-		else if (Input::GetKeyHeld(Keys::A))
+		else if (GameInput::GetKeyHeld(Keys::A))
 		{
-			if (!RotatePlayerOnWallMoveHit(forwardAxis, -rightAxis, -90.f, -90.f, 90.f, 90.f))
+			if (!RotatePlayerOnWallMoveHit(forwardAxis, -rightAxis,
+				WorldTurn::NegativeX, WorldTurn::NegativeZ, WorldTurn::PositiveX, WorldTurn::PositiveZ))
 			{
 				if (CombatMoveCheck())
 				{
-					nextPos = GetPositionV() - (rightAxis * movementIncrement);
-
-					if (IsFloorEmptyOnNextMove())
-					{
-						nextPos = previousPos;
-					}
+					MoveToCell(StepCell(gridPosition, -rightAxis, movementIncrement));
 				}
 			}
 		}
-		else if (Input::GetKeyHeld(Keys::D))
+		else if (GameInput::GetKeyHeld(Keys::D))
 		{
-			if (!RotatePlayerOnWallMoveHit(forwardAxis, rightAxis, 90.f, 90.f, -90.f, -90.f))
+			if (!RotatePlayerOnWallMoveHit(forwardAxis, rightAxis,
+				WorldTurn::PositiveX, WorldTurn::PositiveZ, WorldTurn::NegativeX, WorldTurn::NegativeZ))
 			{
 				if (CombatMoveCheck())
 				{
-					nextPos = GetPositionV() + (rightAxis * movementIncrement);
-
-					if (IsFloorEmptyOnNextMove())
-					{
-						nextPos = previousPos;
-					}
+					MoveToCell(StepCell(gridPosition, rightAxis, movementIncrement));
 				}
 			}
 		}
 	}
 }
 
+void Player::MoveToCell(XMINT3 cell)
+{
+	if (IsFloorEmptyAtCell(cell)) return;
+
+	gridPosition = cell;
+	nextPos = OccupancyGrid::CellToPosition(gridPosition);
+}
+
+//nextPos and nextRot come straight from the grid state and the lerps land on them exactly,
+//so exact compares hold up however many moves the Player makes. Checks the simulated transform,
+//the rendered one is interpolated and lags behind.
 bool Player::CheckIfPlayerMovementAndRotationStopped()
 {
-	return XMVector4Equal(GetPositionV(), nextPos) && XMQuaternionEqual(GetRotationV(), nextRot);
+	return XMVector3Equal(playerSimTransform.GetPosition(), nextPos) &&
+		XMQuaternionEqual(playerSimTransform.GetRotation(), nextRot);
 }
 
 void Player::SetMovementAxis()
 {
-	movementAxes[0] = GetForwardVectorV();
-	movementAxes[1] = -GetForwardVectorV();
-	movementAxes[2] = GetRightVectorV();
-	movementAxes[3] = -GetRightVectorV();
+	PROFILE_FUNCTION();
+
+	const CubeBasis& basis = CubeOrientations::GetBasis(gridOrientation);
+	const GridVector movementAxes[] = { basis.forward, -basis.forward, basis.right, -basis.right };
 
-	float forwardAngle = std::numeric_limits<float>::max();
-	float rightAngle = std::numeric_limits<float>::max();
+	forwardAxis = CubeOrientations::ClosestAxis(camera->GetForwardVectorV(), movementAxes, 4);
+	rightAxis = CubeOrientations::ClosestAxis(camera->GetRightVectorV(), movementAxes, 4);
+}
 
-	for (int i = 0; i < 4; i++)
+bool Player::RotatePlayerOnWallMoveHit(GridVector movementAxis, GridVector raycastAxis,
+	WorldTurn rightTurn, WorldTurn forwardTurn, WorldTurn leftTurn, WorldTurn backTurn)
+{
+	if (!OccupancyGrid::IsSolid(StepCell(gridPosition, raycastAxis, movementIncrement)))
 	{
-		const float tempForwardAngle =
-			std::acos(XMVector3Dot(camera->GetForwardVectorV(), movementAxes[i]).m128_f32[0]);
-		if (tempForwardAngle < forwardAngle)
-		{
-			forwardAngle = tempForwardAngle;
-			forwardAxis = movementAxes[i];
-		}
+		return false;
+	}
 
-		const float tempRightAngle =
-			std::acos(XMVector3Dot(camera->GetRightVectorV(), movementAxes[i]).m128_f32[0]);
-		if (tempRightAngle < rightAngle)
-		{
-			rightAngle = tempRightAngle;
-			rightAxis = movementAxes[i];
-		}
+	//Movement axes are always one of these four, see SetMovementAxis().
+	const CubeBasis& basis = CubeOrientations::GetBasis(gridOrientation);
+	WorldTurn turn = backTurn;
+	if (movementAxis == basis.right)
+	{
+		turn = rightTurn;
 	}
+	else if (movementAxis == basis.forward)
+	{
+		turn = forwardTurn;
+	}
+	else if (movementAxis == -basis.right)
+	{
+		turn = leftTurn;
+	}
+
+	gridOrientation = CubeOrientations::Turn(gridOrientation, turn);
+	nextRot = CubeOrientations::ToQuaternion(gridOrientation);
+
+	shakeOnWallRotateEnd = true;
+
+	return true;
 }
 
-bool Player::RotatePlayerOnWallMoveHit(XMVECTOR movementAxis, XMVECTOR raycastAxis,
-	float rightAngle, float forwardAngle, float leftAngle, float backAngle)
+bool Player::CameraRaycast(float distance, RaycastBatchHit& hit)
 {
-	Ray ray(this);
-	if (Raycast(ray, GetPositionV(), GetPositionV() + (raycastAxis * movementIncrement)))
+	if (!cameraRayBatch.IsExecuted())
 	{
-		if (XMQuaternionEqual(movementAxis, GetRightVectorV()))
-		{
-			nextRot = XMQuaternionMultiply(
-				nextRot, XMQuaternionRotationAxis(VMath::GlobalRightVector(), XMConvertToRadians(rightAngle)));
-		}
-		else if (XMQuaternionEqual(movementAxis, GetForwardVectorV()))
-		{
-			nextRot = XMQuaternionMultiply(
-				nextRot, XMQuaternionRotationAxis(VMath::GlobalForwardVector(), XMConvertToRadians(forwardAngle)));
-		}
-		else if (XMQuaternionEqual(movementAxis, -GetRightVectorV()))
-		{
-			nextRot = XMQuaternionMultiply(
-				nextRot, XMQuaternionRotationAxis(VMath::GlobalRightVector(), XMConvertToRadians(leftAngle)));
-		}
-		else if (XMQuaternionEqual(movementAxis, -GetForwardVectorV()))
-		{
-			nextRot = XMQuaternionMultiply(
-				nextRot, XMQuaternionRotationAxis(VMath::GlobalForwardVector(), XMConvertToRadians(backAngle)));
-		}
-
-		shakeOnWallRotateEnd = true;
-
-		return true;
+		const XMVECTOR origin = GetPositionV();
+		cameraRayBatch.Add(origin, origin + (camera->GetForwardVectorV() * maxCameraRayDistance), this);
+		cameraRayBatch.Execute();
 	}
 
-	return false;
+	return cameraRayBatch.GetHit(0, hit) && hit.hitDistance <= distance;
 }
 
 void Player::ShootInput()
 {
-	if (Input::GetMouseLeftUp())
+	PROFILE_FUNCTION();
+
+	if (GameInput::GetMouseLeftUp())
 	{
-		Ray ray(this);
+		RaycastBatchHit hit;
 		const float shootDistance = 50.f;
-		if (Raycast(ray, GetPositionV(), GetPositionV() + (camera->GetForwardVectorV() * shootDistance)))
+		if (CameraRaycast(shootDistance, hit))
 		{
-			auto enemy = dynamic_cast<Enemy*>(ray.hitActor);
+			auto enemy = dynamic_cast<Enemy*>(hit.hitActor);
 			if (enemy)
 			{
 				enemy->InflictDamage(1);
@@ -337,13 +497,15 @@ void Player::ShootInput()
 
 void Player::Interact()
 {
-	if (Input::GetMouseRightUp())
+	PROFILE_FUNCTION();
+
+	if (GameInput::GetMouseRightUp())
 	{
-		Ray ray(this);
+		RaycastBatchHit hit;
 		const float interactDistance = 2.0f;
-		if (Raycast(ray, GetPositionV(), GetPositionV() + (camera->GetForwardVectorV() * interactDistance)))
+		if (CameraRaycast(interactDistance, hit))
 		{
-			InteractActor* interactActor = dynamic_cast<InteractActor*>(ray.hitActor);
+			InteractActor* interactActor = dynamic_cast<InteractActor*>(hit.hitActor);
 			if (interactActor)
 			{
 				interactActor->Interact();
@@ -352,14 +514,11 @@ void Player::Interact()
 	}
 }
 
-bool Player::IsFloorEmptyOnNextMove()
+bool Player::IsFloorEmptyAtCell(XMINT3 cell)
 {
-	XMVECTOR origin = nextPos;
-	XMVECTOR up = GetUpVectorV();
-	XMVECTOR end = origin - (up * movementIncrement);
+	const GridVector up = CubeOrientations::GetBasis(gridOrientation).up;
 
-	Ray ray(this);
-	if (!Raycast(ray, origin, end))
+	if (!OccupancyGrid::IsSolid(StepCell(cell, -up, movementIncrement)))
 	{
 		Log("Cannot move to empty spot.");
 		return true;
@@ -370,45 +529,51 @@ bool Player::IsFloorEmptyOnNextMove()
 
 void Player::Scan()
 {
+	PROFILE_FUNCTION();
+
 	if (!scanVisorActive) return;
 
-	XMVECTOR origin = GetPositionV();
-	const float scanRange = 50.f;
-	XMVECTOR end = origin + (camera->GetForwardVectorV() * scanRange);
+	if (!scanVisor.Update(GetPositionV(), camera->GetForwardVectorV(), this)) return;
 
-	Ray ray(this);
-	if (Raycast(ray, origin, end))
+	//Only touch the widget's text when it changes, the visor is open for long stretches. Compared by
+	//text rather than by target as a new actor can reuse a destroyed target's address.
+	Actor* scanTarget = scanVisor.GetTarget();
+	if (scanTarget)
 	{
-		Actor* scanTarget = ray.hitActor;
-		if (scanTarget)
+		if (scanTarget->scanText != scanWidget->GetScanInfoText())
 		{
 			scanWidget->SetScanInfoText(scanTarget->scanText);
 		}
-		else
-		{
-			scanWidget->ResetValues();
-		}
 	}
-	else
+	else if (!scanWidget->GetScanInfoText().empty())
 	{
 		scanWidget->ResetValues();
 	}
+
+	scanWidget->SetHighlightPositions(scanVisor.GetHighlightedPositions());
 }
 
 void Player::TakePhoto()
 {
-	if (Input::GetKeyDown(Keys::Num3))
+	PROFILE_FUNCTION();
+
+	if (GameInput::GetKeyDown(Keys::Num3))
 	{
-		if (photoFilenameIndex < photoFilenames.size())
+		if (filmRoll.HasFilmLeft())
 		{
-			Renderer::PlayerPhotoCapture(photoFilenames.at(photoFilenameIndex));
+			const std::wstring& photoFilename = filmRoll.TakeExposure();
+
+			//Readback, JPEG encoding and the file write all happen in here on the game thread. The
+			//Renderer gives game code no pixels to hand to a worker, so this stays synchronous.
+			{
+				PROFILE_ZONE("Renderer::PlayerPhotoCapture");
+				Renderer::PlayerPhotoCapture(photoFilename);
+			}
 
 			RaycastAgainstActorWithPhotoComponent();
 
-			photoWidget->photoFilename = VString::wstos(photoFilenames.at(photoFilenameIndex));
+			photoWidget->photoFilename = VString::wstos(photoFilename);
 			photoWidget->AddToViewport(3.f);
-
-			photoFilenameIndex++;
 		}
 		else
 		{
@@ -419,17 +584,17 @@ void Player::TakePhoto()
 
 void Player::RaycastAgainstActorWithPhotoComponent()
 {
-	Ray ray(this);
+	RaycastBatchHit hit;
 	const float photoDistance = 100.f;
-	if (Raycast(ray, GetPositionV(), GetPositionV() + (camera->GetForwardVectorV() * photoDistance)))
+	if (CameraRaycast(photoDistance, hit))
 	{
-		PhotoComponent* photoComponent = ray.hitActor->GetFirstComponentOfTypeAllowNull<PhotoComponent>();
+		PhotoComponent* photoComponent = hit.hitActor->GetFirstComponentOfTypeAllowNull<PhotoComponent>();
 		if (photoComponent)
 		{
 			if (photoComponent->IsTagPartOfCurrentSalvage())
 			{
 				std::string photoTag = photoComponent->GetPhotoTag();
-				GameInstance::playerPhotoTagsCaptured.insert(photoTag);
+				PhotoTags::MarkCaptured(photoTag);
 				Log("Photo with tag [%s] taken", photoTag.c_str());
 			}
 		}
@@ -438,7 +603,9 @@ void Player::RaycastAgainstActorWithPhotoComponent()
 
 void Player::ScanVisorInputToggle()
 {
-	if (Input::GetKeyDown(Keys::Num1))
+	PROFILE_FUNCTION();
+
+	if (GameInput::GetKeyDown(Keys::Num1))
 	{
 		scanVisorActive = !scanVisorActive;
 
@@ -449,6 +616,8 @@ void Player::ScanVisorInputToggle()
 		else
 		{
 			scanWidget->RemoveFromViewport();
+			scanWidget->ResetValues();
+			scanVisor.Reset();
 		}
 	}
 }
@@ -460,27 +629,39 @@ void Player::CreatePlayerWidgets()
 	salvageMissionWidget = CreateWidget<SalvageMissionWidget>();
 	dialogueWidget = CreateWidget<DialogueWidget>();
 	actionBarWidget = CreateWidget<PlayerActionBarWidget>();
+	uiDrawListWidget = CreateWidget<UIDrawListWidget>();
 }
 
 void Player::SpawnNote()
 {
-	if (Input::GetMouseRightUp())
+	PROFILE_FUNCTION();
+
+	if (GameInput::GetMouseRightUp())
 	{
 		//@Todo: spawn on raycast hit
-		NoteActor* noteActor = NoteActor::system.Add(NoteActor(), GetTransform());
-		noteActor->SetNoteText(L"Testing note text");
-		noteActor->AddNoteWidgetToViewport();
+		XMFLOAT3 position;
+		XMFLOAT4 rotation;
+		XMStoreFloat3(&position, GetPositionV());
+		XMStoreFloat4(&rotation, GetRotationV());
+
+		//Deferred as placing can add the pool's NoteActors if they haven't been yet.
+		JobSystem::Defer([position, rotation]() {
+			NotePool::Place(XMLoadFloat3(&position), XMLoadFloat4(&rotation), L"Testing note text");
+		});
 	}
 }
 
 void Player::ToggleSalvageMissionStats()
 {
-	if (Input::GetKeyDown(Keys::Enter))
+	PROFILE_FUNCTION();
+
+	if (GameInput::GetKeyDown(Keys::Enter))
 	{
 		salvageMissionMenuOpen = !salvageMissionMenuOpen;
 
 		if (salvageMissionMenuOpen)
 		{
+			salvageMissionWidget->InvalidateMissionRows();
 			salvageMissionWidget->AddToViewport();
 		}
 		else
@@ -2,6 +2,7 @@
 
 #include "../Actor.h"
 #include "../ActorSystem.h"
+#include "Gameplay/Game/CubeOrientation.h"
 
 struct CameraComponent;
 class ScanWidget;
@@ -9,6 +10,9 @@ class PhotoWidget;
 class DialogueWidget;
 class SalvageMissionWidget;
 class PlayerActionBarWidget;
+class UIDrawListWidget;
+struct RaycastBatchHit;
+struct PlayerSaveState;
 
 class Player : public Actor
 {
@@ -16,6 +20,7 @@ public:
 	ACTOR_SYSTEM(Player);
 
 	Player();
+	~Player();
 	virtual void Start() override;
 	virtual void Tick(float deltaTime) override;
 	virtual Properties GetProps() override;
@@ -23,15 +28,21 @@ public:
 	void StartDialogue(std::string dialogueFilename);
 	void SetInCombat(bool combatActive);
 
+	void WriteSaveState(PlayerSaveState& state) const;
+	void ReadSaveState(const PlayerSaveState& state);
+
 private:
 	void MovementInput(float deltaTime);
+	void SimulateMovementStep(float stepTime);
 	bool CheckIfPlayerMovementAndRotationStopped();
 	void SetMovementAxis();
-	bool RotatePlayerOnWallMoveHit(XMVECTOR movementAxis, XMVECTOR raycastAxis,
-		float rightAngle, float forwardAngle, float leftAngle, float backAngle);
+	bool RotatePlayerOnWallMoveHit(GridVector movementAxis, GridVector raycastAxis,
+		WorldTurn rightTurn, WorldTurn forwardTurn, WorldTurn leftTurn, WorldTurn backTurn);
+	void MoveToCell(XMINT3 cell);
+	bool CameraRaycast(float distance, RaycastBatchHit& hit);
 	void ShootInput();
 	void Interact();
-	bool IsFloorEmptyOnNextMove();
+	bool IsFloorEmptyAtCell(XMINT3 cell);
 	void Scan();
 	void TakePhoto();
 	void RaycastAgainstActorWithPhotoComponent();
@@ -43,6 +54,8 @@ private:
 	void EndDialogue();
 	bool CombatMoveCheck();
 	void EndCombatTurn();
+	void QuickSaveInput();
+	void DebugCommandInput();
 
 public:
 	CameraComponent* camera = nullptr;
@@ -53,15 +66,34 @@ private:
 	SalvageMissionWidget* salvageMissionWidget = nullptr;
 	DialogueWidget* dialogueWidget = nullptr;
 	PlayerActionBarWidget* actionBarWidget = nullptr;
+	UIDrawListWidget* uiDrawListWidget = nullptr;
 
-	XMVECTOR movementAxes[4]{};
+	//Grid state is what movement works on, nextPos and nextRot are derived from it for rendering.
+	XMINT3 gridPosition = XMINT3(0, 0, 0);
+	CubeOrientation gridOrientation = CubeOrientations::IDENTITY;
 
-	XMVECTOR forwardAxis = XMVectorZero();
-	XMVECTOR rightAxis = XMVectorZero();
+	//Camera relative movement directions, picked from the orientation's forward and right each frame.
+	GridVector forwardAxis = { 0, 0, 1 };
+	GridVector rightAxis = { 1, 0, 0 };
 
 	XMVECTOR nextPos = XMVectorZero();
 	XMVECTOR nextRot = XMVectorZero();
 
+	int filmExposureCount = 5;
+
+	//Placed notes past this reuse the oldest one.
+	int maxNotes = 128;
+
+	//Debug input capture for repeatable runs through a level. Replay wins if both are set.
+	std::string inputRecordFile;
+	std::string inputReplayFile;
+
+	//Frames of profiler zones to write to ProfileCapture.json from level start. 0 is off.
+	int profileCaptureFrames = 0;
+
+	//Fixed rate movement is simulated at, independent of frame rate.
+	float simTickRate = 60.f;
+
 	float moveSpeed = 3.f;
 	float rotSpeed = 2.5f;
 
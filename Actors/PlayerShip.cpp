@@ -1,9 +1,21 @@
 #include "vpch.h"
 #include "PlayerShip.h"
-#include "Input.h"
+#include <algorithm>
 #include "Components/MeshComponent.h"
 #include "Components/CameraComponent.h"
 #include "UI/Game/ClientSalvageMenu.h"
+#include "UI/Game/UIDrawListWidget.h"
+#include "Gameplay/Game/TriggerBroadphase.h"
+#include "Gameplay/Game/LevelLoader.h"
+#include "Gameplay/Game/GameInput.h"
+#include "Gameplay/Game/Profiler.h"
+#include "Gameplay/Game/OverworldStreaming.h"
+#include "Gameplay/Game/MissionCatalogue.h"
+#include "Gameplay/Game/FixedTimestep.h"
+#include "Gameplay/Game/WorldWidgets.h"
+
+FixedTimestep shipTimestep;
+InterpolatedTransform shipSimTransform;
 
 PlayerShip::PlayerShip()
 {
@@ -17,16 +29,39 @@ PlayerShip::PlayerShip()
 
 void PlayerShip::Start()
 {
+    MissionCatalogue::LoadMissions(generatedContractCount);
     clientSalvageMenu = CreateWidget<ClientSalvageMenu>();
+    uiDrawListWidget = CreateWidget<UIDrawListWidget>();
 
     camera->targetActor = this;
+
+    shipTimestep.tickRate = std::max(simTickRate, minFixedTickRate);
+    shipTimestep.Reset();
+    shipSimTransform.Reset(GetPositionV(), GetRotationV());
+
+    OverworldStreaming::Build(this);
 }
 
 void PlayerShip::Tick(float deltaTime)
 {
-    MovementInput(deltaTime);
+    deltaTime = GameInput::BeginFrame(deltaTime, camera);
+
+    PROFILE_FRAME();
+    PROFILE_FUNCTION();
 
-    if (Input::GetKeyUp(Keys::Enter))
+    MovementInput();
+
+    const int stepCount = GameInput::AdvanceTimestep(shipTimestep, deltaTime);
+    for (int i = 0; i < stepCount; i++)
+    {
+        SimulateMovementStep(shipTimestep.GetStepTime());
+    }
+
+    const float alpha = shipTimestep.GetAlpha();
+    SetPosition(shipSimTransform.GetInterpolatedPosition(alpha));
+    SetRotation(shipSimTransform.GetInterpolatedRotation(alpha));
+
+    if (GameInput::GetKeyUp(Keys::Enter))
     {
         if (clientSalvageMenu->IsInViewport())
         {
@@ -37,34 +72,71 @@ void PlayerShip::Tick(float deltaTime)
             clientSalvageMenu->AddToViewport();
         }
     }
+
+    //Before the trigger update as streaming adds and removes triggers and can shift the origin.
+    const XMVECTOR originShift = OverworldStreaming::Update(this, moveSpeed);
+    shipSimTransform.Offset(-originShift);
+
+    TriggerBroadphase::UpdateTarget(this);
+
+    WorldWidgets::Update(WorldWidgets::GetCameraView(camera));
+
+    //After everything above that adds widgets to the viewport.
+    uiDrawListWidget->BeginFrame();
+
+    //Last as it can swap out the world this ship is in.
+    LevelLoader::Update();
 }
 
 Properties PlayerShip::GetProps()
 {
-    return __super::GetProps();
+    Properties props = __super::GetProps();
+    props.Add("Generated Contracts", &generatedContractCount);
+    props.Add("Sim Tick Rate", &simTickRate);
+    return props;
 }
 
-void PlayerShip::MovementInput(float deltaTime)
+void PlayerShip::MovementInput()
 {
-    if (Input::GetKeyHeld(Keys::W))
+    PROFILE_FUNCTION();
+
+    throttleInput = 0;
+    if (GameInput::GetKeyHeld(Keys::W))
+    {
+        throttleInput = 1;
+    }
+    else if (GameInput::GetKeyHeld(Keys::S))
+    {
+        throttleInput = -1;
+    }
+
+    turnInput = 0;
+    if (GameInput::GetKeyHeld(Keys::A))
     {
-        SetPosition(GetPositionV() + (GetForwardVectorV() * moveSpeed * deltaTime));
+        turnInput = -1;
     }
-    else if (Input::GetKeyHeld(Keys::S))
+    else if (GameInput::GetKeyHeld(Keys::D))
     {
-        SetPosition(GetPositionV() - (GetForwardVectorV() * moveSpeed * deltaTime));
+        turnInput = 1;
     }
+}
+
+void PlayerShip::SimulateMovementStep(float stepTime)
+{
+    XMVECTOR position = shipSimTransform.GetPosition();
+    XMVECTOR rotation = shipSimTransform.GetRotation();
 
-    if (Input::GetKeyHeld(Keys::A))
+    if (turnInput != 0)
     {
-        const XMMATRIX r = XMMatrixRotationY(deltaTime * -rotateSpeed);
-        const XMVECTOR q = XMQuaternionMultiply(GetRotationV(), XMQuaternionRotationMatrix(r));
-        SetRotation(q);
+        const XMMATRIX r = XMMatrixRotationY(stepTime * rotateSpeed * (float)turnInput);
+        rotation = XMQuaternionMultiply(rotation, XMQuaternionRotationMatrix(r));
     }
-    else if (Input::GetKeyHeld(Keys::D))
+
+    if (throttleInput != 0)
     {
-        const XMMATRIX r = XMMatrixRotationY(deltaTime * rotateSpeed);
-        const XMVECTOR q = XMQuaternionMultiply(GetRotationV(), XMQuaternionRotationMatrix(r));
-        SetRotation(q);
+        const XMVECTOR forward = XMVector3Rotate(XMVectorSet(0.f, 0.f, 1.f, 0.f), rotation);
+        position += forward * moveSpeed * stepTime * (float)throttleInput;
     }
+
+    shipSimTransform.Push(position, rotation);
 }
@@ -5,6 +5,7 @@
 
 class CameraComponent;
 class ClientSalvageMenu;
+class UIDrawListWidget;
 
 //Ship that travels around world map.
 class PlayerShip : public Actor
@@ -18,12 +19,25 @@ public:
 	virtual Properties GetProps() override;
 
 private:
-	void MovementInput(float deltaTime);
+	//Input is read every frame, movement is integrated in fixed steps.
+	void MovementInput();
+	void SimulateMovementStep(float stepTime);
 
 	CameraComponent* camera = nullptr;
 
 	ClientSalvageMenu* clientSalvageMenu = nullptr;
+	UIDrawListWidget* uiDrawListWidget = nullptr;
 
 	float moveSpeed = 4.f;
 	float rotateSpeed = 2.5f;
+
+	//Fixed rate movement is simulated at, independent of frame rate.
+	float simTickRate = 60.f;
+
+	//-1, 0 or 1 from this frame's input.
+	int throttleInput = 0;
+	int turnInput = 0;
+
+	//Procedural salvage contracts offered alongside the authored missions.
+	int generatedContractCount = 0;
 };
@@ -0,0 +1,127 @@
+#include "vpch.h"
+#include "ActorRef.h"
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#include "World.h"
+
+std::vector<ActorRefBase*> pendingActorRefs;
+//Only actors something has tracked are in here, and they're erased as they're destroyed.
+std::unordered_map<Actor*, uint32_t> trackedActorSerials;
+uint32_t nextActorSerial = 1;
+uint32_t actorRefGeneration = 1;
+
+void ActorRefs::Register(ActorRefBase* actorRef)
+{
+	pendingActorRefs.push_back(actorRef);
+}
+
+void ActorRefs::Unregister(ActorRefBase* actorRef)
+{
+	pendingActorRefs.erase(std::remove(pendingActorRefs.begin(), pendingActorRefs.end(), actorRef),
+		pendingActorRefs.end());
+}
+
+void ActorRefs::ResolvePending()
+{
+	if (pendingActorRefs.empty()) return;
+
+	std::unordered_map<std::string, Actor*> actorsByName;
+	for (Actor* actor : World::GetAllActorsInWorld())
+	{
+		actorsByName.emplace(actor->GetName(), actor);
+	}
+
+	for (ActorRefBase* actorRef : pendingActorRefs)
+	{
+		Actor* actor = nullptr;
+
+		auto actorIt = actorsByName.find(actorRef->actorName);
+		if (actorIt == actorsByName.end())
+		{
+			Log("Actor ref to [%s] not found.", actorRef->actorName.c_str());
+		}
+		else if (!actorRef->AcceptsActor(actorIt->second))
+		{
+			Log("Actor ref to [%s] is the wrong type.", actorRef->actorName.c_str());
+		}
+		else
+		{
+			actor = actorIt->second;
+		}
+
+		actorRef->SetResolvedActor(actor);
+	}
+
+	pendingActorRefs.clear();
+}
+
+uint32_t ActorRefs::Track(Actor* actor)
+{
+	auto serialIt = trackedActorSerials.find(actor);
+	if (serialIt != trackedActorSerials.end())
+	{
+		return serialIt->second;
+	}
+
+	const uint32_t serial = nextActorSerial++;
+	trackedActorSerials.emplace(actor, serial);
+	return serial;
+}
+
+bool ActorRefs::IsAlive(Actor* actor, uint32_t serial)
+{
+	auto serialIt = trackedActorSerials.find(actor);
+	return serialIt != trackedActorSerials.end() && serialIt->second == serial;
+}
+
+void ActorRefs::NotifyDestroyed(Actor* actor)
+{
+	trackedActorSerials.erase(actor);
+	actorRefGeneration++;
+}
+
+uint32_t ActorRefs::GetGeneration()
+{
+	return actorRefGeneration;
+}
+
+void ActorRefs::Reset()
+{
+	pendingActorRefs.clear();
+	trackedActorSerials.clear();
+	actorRefGeneration++;
+}
+
+ActorRefBase::~ActorRefBase()
+{
+	ActorRefs::Unregister(this);
+}
+
+void ActorRefBase::SetResolvedActor(Actor* actor)
+{
+	resolvedActor = actor;
+	resolvedSerial = actor ? ActorRefs::Track(actor) : 0;
+	resolvedGeneration = ActorRefs::GetGeneration();
+	resolved = true;
+}
+
+Actor* ActorRefBase::GetValidatedActor()
+{
+	if (!resolved)
+	{
+		ActorRefs::ResolvePending();
+	}
+
+	if (resolvedActor && resolvedGeneration != ActorRefs::GetGeneration())
+	{
+		if (!ActorRefs::IsAlive(resolvedActor, resolvedSerial))
+		{
+			resolvedActor = nullptr;
+		}
+
+		resolvedGeneration = ActorRefs::GetGeneration();
+	}
+
+	return resolvedActor;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+class Actor;
+class ActorRefBase;
+
+//Name-linked actor references are resolved together in one pass over the world, the first time
+//any of them is read after level load, instead of a world search on every use.
+namespace ActorRefs
+{
+	void Register(ActorRefBase* actorRef);
+	void Unregister(ActorRefBase* actorRef);
+	void ResolvePending();
+
+	//Gives the actor a serial the first time it's tracked. Holders keep the serial alongside the
+	//pointer and check it with IsAlive(), so an address reused by a new actor never passes.
+	uint32_t Track(Actor* actor);
+	bool IsAlive(Actor* actor, uint32_t serial);
+
+	//Drops the actor's serial. Any actor type refs or caches can point at calls this from its
+	//destructor, so every destroy path (including level unload) is covered.
+	void NotifyDestroyed(Actor* actor);
+
+	//Bumped by every NotifyDestroyed(), so holders only need to check IsAlive() when it changes.
+	uint32_t GetGeneration();
+
+	//Drops pending refs and tracked actors. Call before the world is unloaded.
+	void Reset();
+}
+
+class ActorRefBase
+{
+public:
+	virtual ~ActorRefBase();
+
+	//Serialised through GetProps() so levels keep linking actors by name.
+	std::string actorName;
+
+	virtual bool AcceptsActor(Actor* actor) = 0;
+
+	void SetResolvedActor(Actor* actor);
+
+protected:
+	Actor* GetValidatedActor();
+
+private:
+	Actor* resolvedActor = nullptr;
+	uint32_t resolvedSerial = 0;
+
+	//ActorRefs generation the resolved actor was last known to be alive in. Any actor being
+	//destroyed bumps the generation, so the common case is a single integer compare.
+	uint32_t resolvedGeneration = 0;
+
+	bool resolved = false;
+};
+
+//Typed reference to another actor in the level by name, e.g. a DoorSwitch's Door.
+//T has to call ActorRefs::NotifyDestroyed() from its destructor.
+template <typename T>
+class ActorRef : public ActorRefBase
+{
+public:
+	virtual bool AcceptsActor(Actor* actor) override
+	{
+		return dynamic_cast<T*>(actor) != nullptr;
+	}
+
+	//Returns null if the actor wasn't found, isn't a T or has since been destroyed.
+	T* Get()
+	{
+		return static_cast<T*>(GetValidatedActor());
+	}
+};
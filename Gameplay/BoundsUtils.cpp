@@ -0,0 +1,25 @@
+#include "vpch.h"
+#include "BoundsUtils.h"
+#include "Components/SpatialComponent.h"
+
+BoundingOrientedBox BoundsUtils::GetWorldOBB(SpatialComponent* component)
+{
+	BoundingOrientedBox worldBox;
+	component->boundingBox.Transform(worldBox, component->GetWorldMatrix());
+	return worldBox;
+}
+
+BoundingBox BoundsUtils::GetWorldAABB(SpatialComponent* component)
+{
+	return GetEnclosingAABB(GetWorldOBB(component));
+}
+
+BoundingBox BoundsUtils::GetEnclosingAABB(const BoundingOrientedBox& box)
+{
+	XMFLOAT3 corners[BoundingOrientedBox::CORNER_COUNT];
+	box.GetCorners(corners);
+
+	BoundingBox bounds;
+	BoundingBox::CreateFromPoints(bounds, BoundingOrientedBox::CORNER_COUNT, corners, sizeof(XMFLOAT3));
+	return bounds;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <DirectXCollision.h>
+
+using namespace DirectX;
+
+struct SpatialComponent;
+
+namespace BoundsUtils
+{
+	BoundingOrientedBox GetWorldOBB(SpatialComponent* component);
+
+	//Axis-aligned world space box around a component's (oriented) bounding box.
+	BoundingBox GetWorldAABB(SpatialComponent* component);
+
+	//Axis-aligned box around an already transformed oriented box, for callers that need both.
+	BoundingBox GetEnclosingAABB(const BoundingOrientedBox& box);
+}
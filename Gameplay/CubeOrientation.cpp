@@ -0,0 +1,174 @@
+#include "vpch.h"
+#include "CubeOrientation.h"
+#include <cmath>
+#include <random>
+#include "DebugCommands.h"
+
+XMVECTOR CubeOrientations::ToQuaternion(CubeOrientation orientation)
+{
+	const CubeBasis& basis = GetBasis(orientation);
+
+	const XMMATRIX rotation(
+		(float)basis.right.x, (float)basis.right.y, (float)basis.right.z, 0.f,
+		(float)basis.up.x, (float)basis.up.y, (float)basis.up.z, 0.f,
+		(float)basis.forward.x, (float)basis.forward.y, (float)basis.forward.z, 0.f,
+		0.f, 0.f, 0.f, 1.f);
+
+	return XMQuaternionNormalize(XMQuaternionRotationMatrix(rotation));
+}
+
+static GridVector SnapToAxis(XMVECTOR direction)
+{
+	XMFLOAT3 d;
+	XMStoreFloat3(&d, direction);
+
+	const float ax = std::fabs(d.x), ay = std::fabs(d.y), az = std::fabs(d.z);
+	if (ax >= ay && ax >= az) return { d.x > 0.f ? 1 : -1, 0, 0 };
+	if (ay >= az) return { 0, d.y > 0.f ? 1 : -1, 0 };
+	return { 0, 0, d.z > 0.f ? 1 : -1 };
+}
+
+CubeOrientation CubeOrientations::FromQuaternion(XMVECTOR quaternion)
+{
+	const XMMATRIX rotation = XMMatrixRotationQuaternion(quaternion);
+	const GridVector right = SnapToAxis(rotation.r[0]);
+	const GridVector up = SnapToAxis(rotation.r[1]);
+
+	//Right and up pin down forward, matching on them alone keeps a skewed rotation from failing.
+	for (int i = 0; i < CUBE_ORIENTATION_COUNT; i++)
+	{
+		if (bases[i].right == right && bases[i].up == up)
+		{
+			return (CubeOrientation)i;
+		}
+	}
+
+	Log("Rotation isn't close to any axis aligned orientation, using identity.");
+	return IDENTITY;
+}
+
+XMVECTOR CubeOrientations::ToVector(GridVector axis)
+{
+	return XMVectorSet((float)axis.x, (float)axis.y, (float)axis.z, 0.f);
+}
+
+GridVector CubeOrientations::ClosestAxis(XMVECTOR direction, const GridVector* candidates, int candidateCount)
+{
+	XMFLOAT3 d;
+	XMStoreFloat3(&d, direction);
+
+	//Axes are unit length so the dot product alone orders them by angle, no acos needed.
+	int closest = 0;
+	float closestDot = -2.f;
+	for (int i = 0; i < candidateCount; i++)
+	{
+		const float dot = d.x * candidates[i].x + d.y * candidates[i].y + d.z * candidates[i].z;
+		if (dot > closestDot)
+		{
+			closestDot = dot;
+			closest = i;
+		}
+	}
+
+	return candidates[closest];
+}
+
+static GridVector CrossAxes(GridVector a, GridVector b)
+{
+	return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+//An axis rotated by a quarter turn, as a row vector times the turn's XMMatrixRotationX/Y/Z matrix.
+static GridVector TurnAxis(GridVector axis, WorldTurn turn)
+{
+	switch (turn)
+	{
+	case WorldTurn::PositiveX: return { axis.x, -axis.z, axis.y };
+	case WorldTurn::NegativeX: return { axis.x, axis.z, -axis.y };
+	case WorldTurn::PositiveY: return { axis.z, axis.y, -axis.x };
+	case WorldTurn::NegativeY: return { -axis.z, axis.y, axis.x };
+	case WorldTurn::PositiveZ: return { -axis.y, axis.x, axis.z };
+	case WorldTurn::NegativeZ: return { axis.y, -axis.x, axis.z };
+	default: return axis;
+	}
+}
+
+static bool SameBasis(const CubeBasis& a, const CubeBasis& b)
+{
+	return a.right == b.right && a.up == b.up && a.forward == b.forward;
+}
+
+//Checks the hand written tables: 24 distinct right handed bases, every turn landing on the basis the
+//turn's rotation actually gives, quaternions converting back to the same orientation, and a long
+//random walk of table turns agreeing with the same turns done as quaternion multiplies.
+static DebugCommands::Registration cubeOrientationCommand("CubeOrientationTables", []() {
+	using namespace CubeOrientations;
+
+	const WorldTurn inverseTurns[] = { WorldTurn::NegativeX, WorldTurn::PositiveX, WorldTurn::NegativeY,
+		WorldTurn::PositiveY, WorldTurn::NegativeZ, WorldTurn::PositiveZ };
+
+	int failureCount = 0;
+	for (int i = 0; i < CUBE_ORIENTATION_COUNT; i++)
+	{
+		const CubeBasis& basis = bases[i];
+		if (CrossAxes(basis.right, basis.up) != basis.forward)
+		{
+			Log("Cube orientation %d isn't a right handed orthonormal basis.", i);
+			failureCount++;
+		}
+
+		for (int j = 0; j < i; j++)
+		{
+			if (SameBasis(bases[j], basis))
+			{
+				Log("Cube orientations %d and %d have the same basis.", j, i);
+				failureCount++;
+			}
+		}
+
+		if (FromQuaternion(ToQuaternion((CubeOrientation)i)) != i)
+		{
+			Log("Cube orientation %d doesn't survive a quaternion round trip.", i);
+			failureCount++;
+		}
+
+		for (int t = 0; t < (int)WorldTurn::Count; t++)
+		{
+			const WorldTurn turn = (WorldTurn)t;
+			const CubeOrientation turned = Turn((CubeOrientation)i, turn);
+			const CubeBasis expected = { TurnAxis(basis.right, turn), TurnAxis(basis.up, turn), TurnAxis(basis.forward, turn) };
+			if (turned >= CUBE_ORIENTATION_COUNT || !SameBasis(bases[turned], expected))
+			{
+				Log("Cube orientation %d turned by %d gives %d, which isn't the turned basis.", i, t, turned);
+				failureCount++;
+			}
+			else if (Turn(turned, inverseTurns[t]) != i)
+			{
+				Log("Cube orientation %d turned by %d doesn't turn back.", i, t);
+				failureCount++;
+			}
+		}
+	}
+
+	const XMVECTOR turnAxes[] = { XMVectorSet(1.f, 0.f, 0.f, 0.f), XMVectorSet(0.f, 1.f, 0.f, 0.f), XMVectorSet(0.f, 0.f, 1.f, 0.f) };
+
+	std::mt19937 random(1234);
+	CubeOrientation orientation = IDENTITY;
+	XMVECTOR quaternion = XMQuaternionIdentity();
+	for (int step = 0; step < 100000 && failureCount == 0; step++)
+	{
+		const int t = (int)(random() % (int)WorldTurn::Count);
+		orientation = Turn(orientation, (WorldTurn)t);
+
+		const float angle = (t % 2 == 0) ? XM_PIDIV2 : -XM_PIDIV2;
+		quaternion = XMQuaternionNormalize(XMQuaternionMultiply(quaternion, XMQuaternionRotationNormal(turnAxes[t / 2], angle)));
+
+		if (FromQuaternion(quaternion) != orientation)
+		{
+			Log("Cube orientation turn walk disagrees with quaternion turns after %d steps.", step + 1);
+			failureCount++;
+		}
+	}
+
+	return failureCount == 0;
+});
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+//Integer axis along one of the grid's six directions.
+struct GridVector
+{
+	int x, y, z;
+
+	constexpr GridVector operator-() const { return { -x, -y, -z }; }
+	constexpr bool operator==(const GridVector& other) const { return x == other.x && y == other.y && z == other.z; }
+	constexpr bool operator!=(const GridVector& other) const { return !(*this == other); }
+};
+
+//An orientation's local axes in world space, the rows of its rotation matrix.
+struct CubeBasis
+{
+	GridVector right;
+	GridVector up;
+	GridVector forward;
+};
+
+//Quarter turns about the world axes, the same direction XMMatrixRotationX/Y/Z turn for positive angles.
+enum class WorldTurn : uint8_t
+{
+	PositiveX,
+	NegativeX,
+	PositiveY,
+	NegativeY,
+	PositiveZ,
+	NegativeZ,
+	Count
+};
+
+//Index of one of the 24 axis aligned orientations a cube can rest in.
+using CubeOrientation = uint8_t;
+
+static const int CUBE_ORIENTATION_COUNT = 24;
+
+//The Player's wall walking turns are exact table lookups on these rather than quaternion multiplies,
+//so orientation never drifts however long a session goes. Quaternions are only made for rendering.
+namespace CubeOrientations
+{
+	constexpr CubeOrientation IDENTITY = 0;
+
+	constexpr CubeBasis bases[CUBE_ORIENTATION_COUNT] =
+	{
+		{ {  1,  0,  0 }, {  0,  1,  0 }, {  0,  0,  1 } }, //0
+		{ {  1,  0,  0 }, {  0,  0,  1 }, {  0, -1,  0 } }, //1
+		{ {  1,  0,  0 }, {  0,  0, -1 }, {  0,  1,  0 } }, //2
+		{ {  0,  0, -1 }, {  0,  1,  0 }, {  1,  0,  0 } }, //3
+		{ {  0,  0,  1 }, {  0,  1,  0 }, { -1,  0,  0 } }, //4
+		{ {  0,  1,  0 }, { -1,  0,  0 }, {  0,  0,  1 } }, //5
+		{ {  0, -1,  0 }, {  1,  0,  0 }, {  0,  0,  1 } }, //6
+		{ {  1,  0,  0 }, {  0, -1,  0 }, {  0,  0, -1 } }, //7
+		{ {  0,  0, -1 }, {  1,  0,  0 }, {  0, -1,  0 } }, //8
+		{ {  0,  0,  1 }, { -1,  0,  0 }, {  0, -1,  0 } }, //9
+		{ {  0,  1,  0 }, {  0,  0,  1 }, {  1,  0,  0 } }, //10
+		{ {  0, -1,  0 }, {  0,  0,  1 }, { -1,  0,  0 } }, //11
+		{ {  0,  0, -1 }, { -1,  0,  0 }, {  0,  1,  0 } }, //12
+		{ {  0,  0,  1 }, {  1,  0,  0 }, {  0,  1,  0 } }, //13
+		{ {  0,  1,  0 }, {  0,  0, -1 }, { -1,  0,  0 } }, //14
+		{ {  0, -1,  0 }, {  0,  0, -1 }, {  1,  0,  0 } }, //15
+		{ { -1,  0,  0 }, {  0,  1,  0 }, {  0,  0, -1 } }, //16
+		{ { -1,  0,  0 }, {  0, -1,  0 }, {  0,  0,  1 } }, //17
+		{ {  0,  0, -1 }, {  0, -1,  0 }, { -1,  0,  0 } }, //18
+		{ {  0,  0,  1 }, {  0, -1,  0 }, {  1,  0,  0 } }, //19
+		{ {  0,  1,  0 }, {  1,  0,  0 }, {  0,  0, -1 } }, //20
+		{ {  0, -1,  0 }, { -1,  0,  0 }, {  0,  0, -1 } }, //21
+		{ { -1,  0,  0 }, {  0,  0, -1 }, {  0, -1,  0 } }, //22
+		{ { -1,  0,  0 }, {  0,  0,  1 }, {  0,  1,  0 } }, //23
+	};
+
+	constexpr CubeOrientation turnTable[CUBE_ORIENTATION_COUNT][(int)WorldTurn::Count] =
+	{
+		{  1,  2,  3,  4,  5,  6 }, //0
+		{  7,  0,  8,  9, 10, 11 }, //1
+		{  0,  7, 12, 13, 14, 15 }, //2
+		{ 10, 15, 16,  0, 12,  8 }, //3
+		{ 11, 14,  0, 16,  9, 13 }, //4
+		{  9, 12, 10, 14, 17,  0 }, //5
+		{  8, 13, 15, 11,  0, 17 }, //6
+		{  2,  1, 18, 19, 20, 21 }, //7
+		{ 20,  6, 22,  1,  3, 18 }, //8
+		{ 21,  5,  1, 22, 19,  4 }, //9
+		{ 19,  3, 20,  5, 23,  1 }, //10
+		{ 18,  4,  6, 21,  1, 23 }, //11
+		{  5, 21, 23,  2, 18,  3 }, //12
+		{  6, 20,  2, 23,  4, 19 }, //13
+		{  4, 18,  5, 20, 22,  2 }, //14
+		{  3, 19, 21,  6,  2, 22 }, //15
+		{ 23, 22,  4,  3, 21, 20 }, //16
+		{ 22, 23, 19, 18,  6,  5 }, //17
+		{ 14, 11, 17,  7,  8, 12 }, //18
+		{ 15, 10,  7, 17, 13,  9 }, //19
+		{ 13,  8, 14, 10, 16,  7 }, //20
+		{ 12,  9, 11, 15,  7, 16 }, //21
+		{ 16, 17,  9,  8, 15, 14 }, //22
+		{ 17, 16, 13, 12, 11, 10 }, //23
+	};
+
+	constexpr const CubeBasis& GetBasis(CubeOrientation orientation)
+	{
+		return bases[orientation];
+	}
+
+	constexpr CubeOrientation Turn(CubeOrientation orientation, WorldTurn turn)
+	{
+		return turnTable[orientation][(int)turn];
+	}
+
+	XMVECTOR ToQuaternion(CubeOrientation orientation);
+
+	//Snaps to the nearest of the 24 orientations, for rotations coming from level files and saves.
+	CubeOrientation FromQuaternion(XMVECTOR quaternion);
+
+	XMVECTOR ToVector(GridVector axis);
+
+	//The candidate axis pointing most along direction. Ties go to the earlier candidate.
+	GridVector ClosestAxis(XMVECTOR direction, const GridVector* candidates, int candidateCount);
+}
+
+inline XMINT3 StepCell(XMINT3 cell, GridVector axis, int steps = 1)
+{
+	return XMINT3(cell.x + axis.x * steps, cell.y + axis.y * steps, cell.z + axis.z * steps);
+}
@@ -0,0 +1,62 @@
+#include "vpch.h"
+#include "DebugCommands.h"
+#include <chrono>
+#include <vector>
+
+struct NamedDebugCommand
+{
+	std::string name;
+	DebugCommands::Command command;
+};
+
+//Function local so registrations from other files' static initialisers never see it unconstructed.
+static std::vector<NamedDebugCommand>& GetDebugCommands()
+{
+	static std::vector<NamedDebugCommand> commands;
+	return commands;
+}
+
+static bool RunDebugCommand(const NamedDebugCommand& command)
+{
+	const auto start = std::chrono::steady_clock::now();
+	const bool passed = command.command();
+	const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	Log("Debug command [%s] %s in %.2fms.", command.name.c_str(), passed ? "passed" : "FAILED", ms);
+	return passed;
+}
+
+void DebugCommands::Register(const std::string& name, Command command)
+{
+	GetDebugCommands().push_back({ name, std::move(command) });
+}
+
+bool DebugCommands::Execute(const std::string& name)
+{
+	for (const NamedDebugCommand& command : GetDebugCommands())
+	{
+		if (command.name == name)
+		{
+			return RunDebugCommand(command);
+		}
+	}
+
+	Log("No debug command named [%s].", name.c_str());
+	return false;
+}
+
+int DebugCommands::RunAll()
+{
+	int failedCount = 0;
+
+	for (const NamedDebugCommand& command : GetDebugCommands())
+	{
+		if (!RunDebugCommand(command))
+		{
+			failedCount++;
+		}
+	}
+
+	Log("Ran %d debug commands, %d failed.", (int)GetDebugCommands().size(), failedCount);
+	return failedCount;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+//Named self-checks for development builds. Systems register their checks next to their own code
+//and the Player runs every one of them on the debug key, logging what failed.
+namespace DebugCommands
+{
+	//Returns false when the check found a problem, having logged what it was.
+	using Command = std::function<bool()>;
+
+	void Register(const std::string& name, Command command);
+
+	//False if no command has that name or it failed.
+	bool Execute(const std::string& name);
+
+	//Runs every command in registration order. Returns how many failed.
+	int RunAll();
+
+	//For registering from file scope, during static initialisation.
+	struct Registration
+	{
+		Registration(const std::string& name, Command command) { Register(name, std::move(command)); }
+	};
+}
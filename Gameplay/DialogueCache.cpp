@@ -0,0 +1,77 @@
+#include "vpch.h"
+#include "DialogueCache.h"
+#include <list>
+#include <unordered_map>
+#include "Gameplay/DialogueStructures.h"
+
+//Enough for every dialogue in a level plus a few from the last one.
+const size_t maxCachedDialogues = 32;
+
+//Most recently used at the front.
+std::list<std::shared_ptr<const CompiledDialogue>> dialogueLRU;
+std::unordered_map<std::string, std::list<std::shared_ptr<const CompiledDialogue>>::iterator> dialogueLookup;
+
+std::wstring CompiledDialogue::GetLineText(int line) const
+{
+	const wchar_t* start = textPool.data() + lineOffsets[line];
+	return std::wstring(start, lineOffsets[line + 1] - lineOffsets[line]);
+}
+
+static std::shared_ptr<const CompiledDialogue> CompileDialogue(const std::string& filename)
+{
+	Dialogue dialogue;
+	dialogue.filename = filename;
+	dialogue.LoadFromFile();
+
+	auto compiled = std::make_shared<CompiledDialogue>();
+	compiled->filename = filename;
+	compiled->lineOffsets.push_back(0);
+
+	//Dialogue plays from line 0 and stops at the first missing line, anything after a gap is unreachable.
+	for (int line = 0; ; line++)
+	{
+		auto lineIt = dialogue.data.find(line);
+		if (lineIt == dialogue.data.end()) break;
+
+		const std::wstring& text = lineIt->second.text;
+		compiled->textPool.insert(compiled->textPool.end(), text.begin(), text.end());
+		compiled->lineOffsets.push_back((uint32_t)compiled->textPool.size());
+	}
+
+	compiled->textPool.shrink_to_fit();
+	compiled->lineOffsets.shrink_to_fit();
+
+	return compiled;
+}
+
+void DialogueCache::Prefetch(const std::string& filename)
+{
+	Get(filename);
+}
+
+std::shared_ptr<const CompiledDialogue> DialogueCache::Get(const std::string& filename)
+{
+	auto lookupIt = dialogueLookup.find(filename);
+	if (lookupIt != dialogueLookup.end())
+	{
+		dialogueLRU.splice(dialogueLRU.begin(), dialogueLRU, lookupIt->second);
+		return *lookupIt->second;
+	}
+
+	dialogueLRU.push_front(CompileDialogue(filename));
+	dialogueLookup.emplace(filename, dialogueLRU.begin());
+
+	if (dialogueLRU.size() > maxCachedDialogues)
+	{
+		dialogueLookup.erase(dialogueLRU.back()->filename);
+		dialogueLRU.pop_back();
+	}
+
+	return dialogueLRU.front();
+}
+
+void DialogueCache::Clear()
+{
+	dialogueLRU.clear();
+	dialogueLookup.clear();
+}
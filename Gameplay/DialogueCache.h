@@ -0,0 +1,33 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+//Dialogue file compiled down to one contiguous text pool with a line offset table, so a line
+//lookup is an array index instead of a map search.
+struct CompiledDialogue
+{
+	int GetLineCount() const { return (int)lineOffsets.size() - 1; }
+	bool HasLine(int line) const { return line >= 0 && line < GetLineCount(); }
+	std::wstring GetLineText(int line) const;
+
+	std::string filename;
+
+	//Line i's text is textPool[lineOffsets[i], lineOffsets[i + 1]).
+	std::vector<uint32_t> lineOffsets;
+	std::vector<wchar_t> textPool;
+};
+
+//LRU cache of compiled dialogue. Levels prefetch every dialogue file their triggers reference
+//on load so starting a dialogue never has to go to disk.
+namespace DialogueCache
+{
+	void Prefetch(const std::string& filename);
+
+	//Compiles the file on a cache miss.
+	std::shared_ptr<const CompiledDialogue> Get(const std::string& filename);
+
+	//Called on level load, entries are per level.
+	void Clear();
+}
@@ -0,0 +1,337 @@
+#include "vpch.h"
+#include "EnemySimulation.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+#include <vector>
+#include "BoundsUtils.h"
+#include "JobSystem.h"
+#include "OccupancyGrid.h"
+#include "Actors/Game/Enemy.h"
+#include "Components/BoxTriggerComponent.h"
+#include "UI/Game/EnemyHealthWidget.h"
+#include "DebugCommands.h"
+#include "Profiler.h"
+
+//Enemies per parallel task. Small enough to spread a few hundred enemies over the cores,
+//big enough that a horde isn't thousands of tiny tasks.
+const int enemyChunkSize = 256;
+
+enum EnemyEvents : uint8_t
+{
+	EnteredAggro = 1 << 0,
+	HealthChanged = 1 << 1,
+};
+
+struct EnemyEvent
+{
+	uint32_t index;
+	uint8_t events;
+};
+
+std::vector<Enemy*> simEnemies;
+
+std::vector<float> simPosX, simPosY, simPosZ;
+
+//Aggro bounds kept as an offset from the enemy's position and half extents, so they follow it.
+std::vector<float> simAggroOffsetX, simAggroOffsetY, simAggroOffsetZ;
+std::vector<float> simAggroExtentX, simAggroExtentY, simAggroExtentZ;
+
+std::vector<int> simHealth;
+std::vector<int> simDisplayedHealth;
+std::vector<uint8_t> simInCombat;
+
+//OccupancyGrid cell indices taken for the current enemy turn.
+std::unordered_set<int> combatReservedCells;
+
+//Written by each chunk independently then applied serially on the game thread.
+std::vector<std::vector<EnemyEvent>> simChunkEvents;
+//Chunks the last tick task was set up with. Zero once applied, so nothing is applied twice.
+int simTickChunkCount = 0;
+
+template <typename Func>
+static void ForEachEnemyArray(Func func)
+{
+	func(simPosX); func(simPosY); func(simPosZ);
+	func(simAggroOffsetX); func(simAggroOffsetY); func(simAggroOffsetZ);
+	func(simAggroExtentX); func(simAggroExtentY); func(simAggroExtentZ);
+	func(simHealth); func(simDisplayedHealth);
+	func(simInCombat);
+}
+
+static void TickEnemyChunk(int start, int end, XMFLOAT3 target)
+{
+	std::vector<EnemyEvent>& events = simChunkEvents[start / enemyChunkSize];
+	events.clear();
+
+	for (int i = start; i < end; i++)
+	{
+		uint8_t enemyEvents = 0;
+
+		const bool inAggroBounds =
+			std::abs(target.x - (simPosX[i] + simAggroOffsetX[i])) <= simAggroExtentX[i] &&
+			std::abs(target.y - (simPosY[i] + simAggroOffsetY[i])) <= simAggroExtentY[i] &&
+			std::abs(target.z - (simPosZ[i] + simAggroOffsetZ[i])) <= simAggroExtentZ[i];
+		if (inAggroBounds && !simInCombat[i])
+		{
+			enemyEvents |= EnteredAggro;
+		}
+
+		if (simHealth[i] != simDisplayedHealth[i])
+		{
+			enemyEvents |= HealthChanged;
+		}
+
+		if (enemyEvents)
+		{
+			events.push_back({ (uint32_t)i, enemyEvents });
+		}
+	}
+}
+
+void EnemySimulation::Add(Enemy* enemy)
+{
+	const int index = (int)simEnemies.size();
+	enemy->simulationIndex = index;
+	simEnemies.push_back(enemy);
+
+	ForEachEnemyArray([](auto& values) { values.emplace_back(); });
+
+	XMFLOAT3 pos;
+	XMStoreFloat3(&pos, enemy->GetPositionV());
+	simPosX[index] = pos.x;
+	simPosY[index] = pos.y;
+	simPosZ[index] = pos.z;
+
+	const BoundingBox aggroBounds = BoundsUtils::GetWorldAABB(enemy->aggroTrigger);
+	simAggroOffsetX[index] = aggroBounds.Center.x - pos.x;
+	simAggroOffsetY[index] = aggroBounds.Center.y - pos.y;
+	simAggroOffsetZ[index] = aggroBounds.Center.z - pos.z;
+	simAggroExtentX[index] = aggroBounds.Extents.x;
+	simAggroExtentY[index] = aggroBounds.Extents.y;
+	simAggroExtentZ[index] = aggroBounds.Extents.z;
+
+	simHealth[index] = Enemy::START_HEALTH_POINTS;
+	//Forces the first tick to push health out to the widget.
+	simDisplayedHealth[index] = -1;
+}
+
+void EnemySimulation::Remove(Enemy* enemy)
+{
+	const int index = enemy->simulationIndex;
+	if (index < 0) return;
+
+	//Swap the last enemy into the removed slot to keep the arrays packed.
+	const int last = (int)simEnemies.size() - 1;
+	simEnemies[index] = simEnemies[last];
+	simEnemies[index]->simulationIndex = index;
+	simEnemies.pop_back();
+
+	ForEachEnemyArray([index, last](auto& values) {
+		values[index] = values[last];
+		values.pop_back();
+	});
+
+	enemy->simulationIndex = -1;
+}
+
+int EnemySimulation::InflictDamage(Enemy* enemy, int damageAmount)
+{
+	int& health = simHealth[enemy->simulationIndex];
+	health -= damageAmount;
+	return health;
+}
+
+int EnemySimulation::GetHealthPoints(Enemy* enemy)
+{
+	return simHealth[enemy->simulationIndex];
+}
+
+void EnemySimulation::SetPosition(Enemy* enemy, XMVECTOR position)
+{
+	const int index = enemy->simulationIndex;
+
+	XMFLOAT3 pos;
+	XMStoreFloat3(&pos, position);
+	simPosX[index] = pos.x;
+	simPosY[index] = pos.y;
+	simPosZ[index] = pos.z;
+}
+
+JobSystem::SystemTask EnemySimulation::GetTickTask(XMVECTOR targetPosition)
+{
+	XMFLOAT3 target;
+	XMStoreFloat3(&target, targetPosition);
+
+	simTickChunkCount = ((int)simEnemies.size() + enemyChunkSize - 1) / enemyChunkSize;
+	if ((int)simChunkEvents.size() < simTickChunkCount)
+	{
+		simChunkEvents.resize(simTickChunkCount);
+	}
+
+	JobSystem::SystemTask task;
+	task.name = "EnemySimulation Tick";
+	task.reads = { &simPosX, &simAggroOffsetX, &simAggroExtentX, &simHealth, &simDisplayedHealth, &simInCombat };
+	task.writes = { &simChunkEvents };
+	task.run = [target]() {
+		JobSystem::ParallelFor((int)simEnemies.size(), enemyChunkSize,
+			[target](int start, int end) { TickEnemyChunk(start, end, target); });
+	};
+	return task;
+}
+
+void EnemySimulation::ApplyTick()
+{
+	PROFILE_FUNCTION();
+
+	for (int chunk = 0; chunk < simTickChunkCount; chunk++)
+	{
+		for (const EnemyEvent& event : simChunkEvents[chunk])
+		{
+			const uint32_t i = event.index;
+			Enemy* enemy = simEnemies[i];
+
+			if (event.events & HealthChanged)
+			{
+				enemy->healthWidget->healthPoints = simHealth[i];
+				simDisplayedHealth[i] = simHealth[i];
+			}
+
+			if (event.events & EnteredAggro)
+			{
+				simInCombat[i] = true;
+				enemy->PlayerEnteredAggroTrigger();
+			}
+		}
+
+		simChunkEvents[chunk].clear();
+	}
+
+	simTickChunkCount = 0;
+}
+
+void EnemySimulation::BeginCombatTurn(XMINT3 targetCell)
+{
+	combatReservedCells.clear();
+	combatReservedCells.insert(OccupancyGrid::CellToIndex(targetCell));
+
+	for (size_t i = 0; i < simEnemies.size(); i++)
+	{
+		const XMINT3 cell = OccupancyGrid::PositionToCell(XMVectorSet(simPosX[i], simPosY[i], simPosZ[i], 1.f));
+		combatReservedCells.insert(OccupancyGrid::CellToIndex(cell));
+	}
+
+	//Cells outside the grid all share -1, they're not worth reserving.
+	combatReservedCells.erase(-1);
+}
+
+bool EnemySimulation::IsCellReserved(XMINT3 cell)
+{
+	return combatReservedCells.find(OccupancyGrid::CellToIndex(cell)) != combatReservedCells.end();
+}
+
+void EnemySimulation::MoveCellReservation(XMINT3 from, XMINT3 to)
+{
+	combatReservedCells.erase(OccupancyGrid::CellToIndex(from));
+
+	const int toIndex = OccupancyGrid::CellToIndex(to);
+	if (toIndex >= 0)
+	{
+		combatReservedCells.insert(toIndex);
+	}
+}
+
+int EnemySimulation::GetEnemyCount()
+{
+	return (int)simEnemies.size();
+}
+
+void EnemySimulation::Reset()
+{
+	for (Enemy* enemy : simEnemies)
+	{
+		enemy->simulationIndex = -1;
+	}
+
+	simEnemies.clear();
+	ForEachEnemyArray([](auto& values) { values.clear(); });
+	combatReservedCells.clear();
+	simChunkEvents.clear();
+	simTickChunkCount = 0;
+}
+
+//Checks the arrays are packed and indexed consistently, then runs the parallel chunk tick and compares
+//its events with a straightforward serial pass over every enemy. Events aren't applied, so enemies
+//are left as they were.
+static DebugCommands::Registration enemySimulationCommand("EnemySimulationMatchesSerial", []() {
+	bool passed = true;
+
+	for (size_t i = 0; i < simEnemies.size(); i++)
+	{
+		if (simEnemies[i]->simulationIndex != (int)i)
+		{
+			Log("Enemy [%s] has simulation index %d but is stored at %d.", simEnemies[i]->GetName().c_str(),
+				simEnemies[i]->simulationIndex, (int)i);
+			passed = false;
+		}
+	}
+
+	ForEachEnemyArray([&passed](auto& values) {
+		if (values.size() != simEnemies.size())
+		{
+			Log("Enemy simulation array has %d entries for %d enemies.", (int)values.size(), (int)simEnemies.size());
+			passed = false;
+		}
+	});
+
+	if (!passed || simEnemies.empty()) return passed;
+
+	//Inside the first enemy's aggro bounds, so at least one enemy should report entering aggro unless
+	//it's already in combat.
+	const XMFLOAT3 target(simPosX[0] + simAggroOffsetX[0], simPosY[0] + simAggroOffsetY[0], simPosZ[0] + simAggroOffsetZ[0]);
+
+	const int chunkCount = ((int)simEnemies.size() + enemyChunkSize - 1) / enemyChunkSize;
+	if ((int)simChunkEvents.size() < chunkCount)
+	{
+		simChunkEvents.resize(chunkCount);
+	}
+
+	JobSystem::ParallelFor((int)simEnemies.size(), enemyChunkSize,
+		[target](int start, int end) { TickEnemyChunk(start, end, target); });
+
+	std::vector<uint8_t> parallelEvents(simEnemies.size(), 0);
+	for (int chunk = 0; chunk < chunkCount; chunk++)
+	{
+		for (const EnemyEvent& event : simChunkEvents[chunk])
+		{
+			parallelEvents[event.index] |= event.events;
+		}
+		simChunkEvents[chunk].clear();
+	}
+
+	for (size_t i = 0; i < simEnemies.size(); i++)
+	{
+		const BoundingBox aggroBounds(
+			XMFLOAT3(simPosX[i] + simAggroOffsetX[i], simPosY[i] + simAggroOffsetY[i], simPosZ[i] + simAggroOffsetZ[i]),
+			XMFLOAT3(simAggroExtentX[i], simAggroExtentY[i], simAggroExtentZ[i]));
+
+		uint8_t expectedEvents = 0;
+		if (!simInCombat[i] && aggroBounds.Contains(XMLoadFloat3(&target)) != DISJOINT)
+		{
+			expectedEvents |= EnteredAggro;
+		}
+		if (simHealth[i] != simDisplayedHealth[i])
+		{
+			expectedEvents |= HealthChanged;
+		}
+
+		if (parallelEvents[i] != expectedEvents)
+		{
+			Log("Enemy [%s] got events %u from the parallel tick, expected %u.", simEnemies[i]->GetName().c_str(),
+				parallelEvents[i], expectedEvents);
+			passed = false;
+		}
+	}
+
+	return passed;
+});
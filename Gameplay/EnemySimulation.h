@@ -0,0 +1,42 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include "JobSystem.h"
+
+using namespace DirectX;
+
+class Enemy;
+
+//Structure-of-arrays state for every Enemy in the level: positions, health, combat state and
+//aggro bounds. Ticked in parallel chunks, with results only written back to the Enemy actors
+//and their widgets when something changed.
+class EnemySimulation
+{
+public:
+	static void Add(Enemy* enemy);
+	//Also called from ~Enemy, so destroying an enemy by any path takes it out of the arrays.
+	static void Remove(Enemy* enemy);
+
+	//Returns the enemy's health after the damage.
+	static int InflictDamage(Enemy* enemy, int damageAmount);
+	static int GetHealthPoints(Enemy* enemy);
+
+	//Moves the enemy's simulated position. Its aggro bounds follow on the next Tick.
+	static void SetPosition(Enemy* enemy, XMVECTOR position);
+
+	//Tests every enemy against targetPosition's aggro bounds and for health changes, in parallel
+	//chunks. Only reads the simulation's own arrays, the world is left to ApplyTick().
+	static JobSystem::SystemTask GetTickTask(XMVECTOR targetPosition);
+	//Game thread, once the tick task has run. Pushes its results out to the enemies and their widgets.
+	static void ApplyTick();
+
+	//Reserves every enemy's cell and the target's for the enemy turn about to be taken, so
+	//enemies planning one after another don't all end up on the same cell.
+	static void BeginCombatTurn(XMINT3 targetCell);
+	static bool IsCellReserved(XMINT3 cell);
+	//Frees from and reserves to once an enemy has picked where it's moving this turn.
+	static void MoveCellReservation(XMINT3 from, XMINT3 to);
+
+	static int GetEnemyCount();
+	static void Reset();
+};
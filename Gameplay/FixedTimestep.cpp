@@ -0,0 +1,56 @@
+#include "vpch.h"
+#include "FixedTimestep.h"
+#include <algorithm>
+
+int FixedTimestep::Advance(float deltaTime)
+{
+	const float stepTime = GetStepTime();
+
+	accumulator += deltaTime;
+
+	int stepCount = (int)(accumulator / stepTime);
+	if (stepCount > maxStepsPerFrame)
+	{
+		stepCount = maxStepsPerFrame;
+		accumulator = 0.f;
+		return stepCount;
+	}
+
+	accumulator -= stepCount * stepTime;
+	//Float error can leave it a hair under zero.
+	accumulator = std::max(accumulator, 0.f);
+
+	return stepCount;
+}
+
+void InterpolatedTransform::Reset(XMVECTOR position, XMVECTOR rotation)
+{
+	XMStoreFloat3(&currentPosition, position);
+	XMStoreFloat4(&currentRotation, rotation);
+	previousPosition = currentPosition;
+	previousRotation = currentRotation;
+}
+
+void InterpolatedTransform::Push(XMVECTOR position, XMVECTOR rotation)
+{
+	previousPosition = currentPosition;
+	previousRotation = currentRotation;
+	XMStoreFloat3(&currentPosition, position);
+	XMStoreFloat4(&currentRotation, rotation);
+}
+
+void InterpolatedTransform::Offset(XMVECTOR offset)
+{
+	XMStoreFloat3(&previousPosition, XMLoadFloat3(&previousPosition) + offset);
+	XMStoreFloat3(&currentPosition, XMLoadFloat3(&currentPosition) + offset);
+}
+
+XMVECTOR InterpolatedTransform::GetInterpolatedPosition(float alpha) const
+{
+	return XMVectorSetW(XMVectorLerp(XMLoadFloat3(&previousPosition), XMLoadFloat3(&currentPosition), alpha), 1.f);
+}
+
+XMVECTOR InterpolatedTransform::GetInterpolatedRotation(float alpha) const
+{
+	return XMQuaternionSlerp(XMLoadFloat4(&previousRotation), XMLoadFloat4(&currentRotation), alpha);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+//Floor for tick rates coming from editable properties. Anything at or below zero would make for
+//infinite or negative step times.
+const float minFixedTickRate = 1.f;
+
+//Turns variable frame times into a whole number of fixed simulation steps so gameplay comes out the
+//same whatever the frame rate. Frames can run any number of steps, including none.
+class FixedTimestep
+{
+public:
+	//Adds the frame's time and returns how many steps to simulate. Anything past maxStepsPerFrame is
+	//dropped so a long hitch doesn't snowball into even longer frames catching up.
+	int Advance(float deltaTime);
+
+	float GetStepTime() const { return 1.f / tickRate; }
+
+	//How far the frame is between the last step and the next, 0 to 1. For interpolating rendering.
+	float GetAlpha() const { return accumulator * tickRate; }
+
+	void Reset() { accumulator = 0.f; }
+
+	float tickRate = 60.f;
+	int maxStepsPerFrame = 8;
+
+private:
+	float accumulator = 0.f;
+};
+
+//An actor's last two simulated transforms. Simulation reads and writes the current one, the actor's
+//own transform is set between the two for rendering.
+class InterpolatedTransform
+{
+public:
+	//Snaps both transforms, for spawning and teleporting.
+	void Reset(XMVECTOR position, XMVECTOR rotation);
+
+	//Called once per simulation step with its result.
+	void Push(XMVECTOR position, XMVECTOR rotation);
+
+	//Moves both transforms, for when the world's origin shifts under the actor.
+	void Offset(XMVECTOR offset);
+
+	XMVECTOR GetPosition() const { return XMLoadFloat3(&currentPosition); }
+	XMVECTOR GetRotation() const { return XMLoadFloat4(&currentRotation); }
+
+	XMVECTOR GetInterpolatedPosition(float alpha) const;
+	XMVECTOR GetInterpolatedRotation(float alpha) const;
+
+private:
+	XMFLOAT3 previousPosition = {};
+	XMFLOAT3 currentPosition = {};
+	XMFLOAT4 previousRotation = { 0.f, 0.f, 0.f, 1.f };
+	XMFLOAT4 currentRotation = { 0.f, 0.f, 0.f, 1.f };
+};
@@ -0,0 +1,207 @@
+#include "vpch.h"
+#include "FlowField.h"
+#include <algorithm>
+#include <climits>
+#include <vector>
+#include "OccupancyGrid.h"
+#include "GridPathfinder.h"
+#include "DebugCommands.h"
+#include "Actors/Game/Player.h"
+#include "Profiler.h"
+
+const XMINT3 flowNeighbours[6] =
+{
+	{ 1, 0, 0 }, { -1, 0, 0 },
+	{ 0, 1, 0 }, { 0, -1, 0 },
+	{ 0, 0, 1 }, { 0, 0, -1 },
+};
+
+const uint8_t noFlowDirection = UINT8_MAX;
+
+//A cell's distance and direction are only valid if its stamp matches the current build. Saves
+//clearing the whole grid's worth of data every build, so a rebuild only costs the cells it reaches.
+std::vector<uint32_t> flowStamp;
+std::vector<uint16_t> flowDistance;
+//Index into flowNeighbours of the step toward the target.
+std::vector<uint8_t> flowDirection;
+std::vector<int> flowQueue;
+uint32_t currentFlowBuild = 0;
+
+XMINT3 flowTargetCell = { INT_MAX, INT_MAX, INT_MAX };
+uint32_t flowGridVersion = 0;
+
+static int FlowCellIndex(XMINT3 cell)
+{
+	const int index = OccupancyGrid::CellToIndex(cell);
+	if (index < 0 || index >= (int)flowStamp.size() || flowStamp[index] != currentFlowBuild)
+	{
+		return -1;
+	}
+
+	return index;
+}
+
+void FlowField::Update(XMINT3 targetCell)
+{
+	PROFILE_FUNCTION();
+
+	const bool targetMoved = targetCell.x != flowTargetCell.x || targetCell.y != flowTargetCell.y ||
+		targetCell.z != flowTargetCell.z;
+	if (!targetMoved && flowGridVersion == OccupancyGrid::GetVersion()) return;
+
+	flowTargetCell = targetCell;
+	flowGridVersion = OccupancyGrid::GetVersion();
+
+	const size_t cellCount = OccupancyGrid::GetCellCount();
+	if (flowStamp.size() != cellCount)
+	{
+		flowStamp.assign(cellCount, 0);
+		flowDistance.resize(cellCount);
+		flowDirection.resize(cellCount);
+		currentFlowBuild = 0;
+	}
+
+	currentFlowBuild++;
+	flowQueue.clear();
+
+	const int targetIndex = OccupancyGrid::CellToIndex(targetCell);
+	if (targetIndex < 0) return;
+
+	flowStamp[targetIndex] = currentFlowBuild;
+	flowDistance[targetIndex] = 0;
+	flowDirection[targetIndex] = noFlowDirection;
+	flowQueue.push_back(targetIndex);
+
+	//Every step costs the same so a plain breadth-first pass gives shortest distances.
+	for (size_t head = 0; head < flowQueue.size(); head++)
+	{
+		const int currentIndex = flowQueue[head];
+		const int nextDistance = flowDistance[currentIndex] + 1;
+		if (nextDistance > MAX_FIELD_DISTANCE) continue;
+
+		const XMINT3 current = OccupancyGrid::IndexToCell(currentIndex);
+
+		for (int direction = 0; direction < 6; direction++)
+		{
+			const XMINT3& offset = flowNeighbours[direction];
+			const XMINT3 neighbour(current.x + offset.x, current.y + offset.y, current.z + offset.z);
+
+			const int neighbourIndex = OccupancyGrid::CellToIndex(neighbour);
+			if (neighbourIndex < 0 || flowStamp[neighbourIndex] == currentFlowBuild) continue;
+			if (!(OccupancyGrid::GetCellFlags(neighbour) & OccupancyGrid::Floor)) continue;
+
+			flowStamp[neighbourIndex] = currentFlowBuild;
+			flowDistance[neighbourIndex] = (uint16_t)nextDistance;
+			//Neighbours are stored in opposite pairs, so flipping the low bit points back at current.
+			flowDirection[neighbourIndex] = (uint8_t)(direction ^ 1);
+			flowQueue.push_back(neighbourIndex);
+		}
+	}
+}
+
+bool FlowField::IsCovered(XMINT3 cell)
+{
+	return FlowCellIndex(cell) >= 0;
+}
+
+int FlowField::GetDistance(XMINT3 cell)
+{
+	const int index = FlowCellIndex(cell);
+	if (index < 0) return -1;
+	return flowDistance[index];
+}
+
+bool FlowField::GetNextCell(XMINT3 cell, XMINT3& outNextCell)
+{
+	const int index = FlowCellIndex(cell);
+	if (index < 0 || flowDirection[index] == noFlowDirection) return false;
+
+	const XMINT3& offset = flowNeighbours[flowDirection[index]];
+	outNextCell = XMINT3(cell.x + offset.x, cell.y + offset.y, cell.z + offset.z);
+	return true;
+}
+
+void FlowField::Reset()
+{
+	flowStamp.clear();
+	flowDistance.clear();
+	flowDirection.clear();
+	flowQueue.clear();
+	flowTargetCell = XMINT3(INT_MAX, INT_MAX, INT_MAX);
+}
+
+//Floods the whole grid from the Player's cell with a plain breadth-first search and checks the flow
+//field's distances and directions against it, then checks A* finds paths of the same length for a
+//spread of the covered cells.
+static DebugCommands::Registration flowFieldCommand("FlowFieldMatchesBruteForce", []() {
+	Player* player = Player::system.GetFirstActor();
+	if (!player || !OccupancyGrid::IsBuilt()) return true;
+
+	const XMINT3 target = OccupancyGrid::PositionToCell(player->GetPositionV());
+	const int targetIndex = OccupancyGrid::CellToIndex(target);
+	if (targetIndex < 0) return true;
+
+	FlowField::Update(target);
+
+	std::vector<int> distances(OccupancyGrid::GetCellCount(), -1);
+	std::vector<int> queue = { targetIndex };
+	distances[targetIndex] = 0;
+	for (size_t head = 0; head < queue.size(); head++)
+	{
+		const XMINT3 current = OccupancyGrid::IndexToCell(queue[head]);
+		for (const XMINT3& offset : flowNeighbours)
+		{
+			const XMINT3 neighbour(current.x + offset.x, current.y + offset.y, current.z + offset.z);
+			const int neighbourIndex = OccupancyGrid::CellToIndex(neighbour);
+			if (neighbourIndex < 0 || distances[neighbourIndex] >= 0) continue;
+			if (!(OccupancyGrid::GetCellFlags(neighbour) & OccupancyGrid::Floor)) continue;
+
+			distances[neighbourIndex] = distances[queue[head]] + 1;
+			queue.push_back(neighbourIndex);
+		}
+	}
+
+	int mismatchCount = 0;
+	std::vector<int> coveredIndices;
+
+	for (int index = 0; index < (int)distances.size(); index++)
+	{
+		const XMINT3 cell = OccupancyGrid::IndexToCell(index);
+		const int distance = distances[index];
+		const int expected = distance <= FlowField::MAX_FIELD_DISTANCE ? distance : -1;
+
+		if (FlowField::GetDistance(cell) != expected)
+		{
+			Log("Flow field distance at [%d, %d, %d] is %d, breadth-first search gives %d.",
+				cell.x, cell.y, cell.z, FlowField::GetDistance(cell), expected);
+			mismatchCount++;
+			continue;
+		}
+
+		if (expected <= 0) continue;
+		coveredIndices.push_back(index);
+
+		XMINT3 nextCell;
+		if (!FlowField::GetNextCell(cell, nextCell) || distances[OccupancyGrid::CellToIndex(nextCell)] != expected - 1)
+		{
+			Log("Flow field at [%d, %d, %d] doesn't step one closer to the target.", cell.x, cell.y, cell.z);
+			mismatchCount++;
+		}
+	}
+
+	const size_t pathChecks = 64;
+	const size_t pathStride = std::max<size_t>(1, coveredIndices.size() / pathChecks);
+	for (size_t i = 0; i < coveredIndices.size(); i += pathStride)
+	{
+		const XMINT3 start = OccupancyGrid::IndexToCell(coveredIndices[i]);
+		const GridPathfinder::PathResult& path = GridPathfinder::FindPath(start, target, FlowField::MAX_FIELD_DISTANCE);
+		if (!path.reachedGoal || (int)path.path.size() != distances[coveredIndices[i]])
+		{
+			Log("A* from [%d, %d, %d] took %d steps, breadth-first search gives %d.", start.x, start.y, start.z,
+				(int)path.path.size(), distances[coveredIndices[i]]);
+			mismatchCount++;
+		}
+	}
+
+	return mismatchCount == 0;
+});
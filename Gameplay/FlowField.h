@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+//Breadth-first distance and direction field over the OccupancyGrid's floor cells, spreading out
+//from a single target cell (the Player). Built once and then read by any number of enemies, where
+//running A* per enemy toward the same target would repeat the same search over and over.
+namespace FlowField
+{
+	//Rebuilds the field if the target cell or the grid (e.g. a door opening) changed since the
+	//last build, otherwise does nothing.
+	void Update(XMINT3 targetCell);
+
+	//Cells further than this many steps from the target aren't covered by the field.
+	static const int MAX_FIELD_DISTANCE = 128;
+
+	bool IsCovered(XMINT3 cell);
+
+	//Steps from cell to the target, -1 if not covered.
+	int GetDistance(XMINT3 cell);
+
+	//Neighbouring cell one step closer to the target. False if not covered or already on the target.
+	bool GetNextCell(XMINT3 cell, XMINT3& outNextCell);
+
+	void Reset();
+}
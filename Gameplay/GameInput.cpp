@@ -0,0 +1,259 @@
+#include "vpch.h"
+#include "GameInput.h"
+#include <fstream>
+#include "Components/SpatialComponent.h"
+#include "FixedTimestep.h"
+
+//Every key gameplay reads. A frame stores one bit per key for each of held, down and up.
+const Keys recordedKeys[] =
+{
+	Keys::W, Keys::A, Keys::S, Keys::D,
+	Keys::Num1, Keys::Num3,
+	Keys::Enter, Keys::Down, Keys::Space,
+	Keys::Up,
+	Keys::F5, Keys::F9,
+	Keys::F10,
+};
+const int recordedKeyCount = sizeof(recordedKeys) / sizeof(recordedKeys[0]);
+static_assert(recordedKeyCount <= 16, "Recorded key bits no longer fit in a uint16_t.");
+
+const uint32_t inputStreamMagic = 0x504E4956; //"VINP"
+//2 added the camera's rotation to every frame.
+//3 added the sim tick rate to the header and each frame's fixed step count.
+const uint32_t inputStreamVersion = 3;
+
+enum MouseBits : uint8_t
+{
+	MouseLeftUp = 1 << 0,
+	MouseRightUp = 1 << 1,
+};
+
+struct InputFrame
+{
+	float deltaTime = 0.f;
+	uint16_t keysHeld = 0;
+	uint16_t keysDown = 0;
+	uint16_t keysUp = 0;
+	uint8_t mouse = 0;
+	//Mouse look only reaches gameplay through the camera, so its result is recorded rather than
+	//the raw mouse deltas.
+	XMFLOAT4 cameraRotation = { 0.f, 0.f, 0.f, 1.f };
+	//Fixed simulation steps the frame ran. Replays run exactly these instead of re-accumulating
+	//the recorded delta times, so float drift can't add or drop a step.
+	uint8_t simSteps = 0;
+};
+
+InputFrame currentInputFrame;
+
+//The live frame isn't written until its step count is known, on the next BeginFrame() or StopRecording().
+bool recordFramePending = false;
+
+float replayTickRate = 0.f;
+
+std::ofstream inputRecordStream;
+std::ifstream inputReplayStream;
+
+static int FindRecordedKey(Keys key)
+{
+	for (int i = 0; i < recordedKeyCount; i++)
+	{
+		if (recordedKeys[i] == key) return i;
+	}
+
+	return -1;
+}
+
+static InputFrame SampleLiveInput(float deltaTime, SpatialComponent* camera)
+{
+	InputFrame frame;
+	frame.deltaTime = deltaTime;
+
+	if (camera)
+	{
+		XMStoreFloat4(&frame.cameraRotation, camera->GetRotationV());
+	}
+
+	for (int i = 0; i < recordedKeyCount; i++)
+	{
+		const uint16_t bit = 1 << i;
+		if (Input::GetKeyHeld(recordedKeys[i])) frame.keysHeld |= bit;
+		if (Input::GetKeyDown(recordedKeys[i])) frame.keysDown |= bit;
+		if (Input::GetKeyUp(recordedKeys[i])) frame.keysUp |= bit;
+	}
+
+	if (Input::GetMouseLeftUp()) frame.mouse |= MouseLeftUp;
+	if (Input::GetMouseRightUp()) frame.mouse |= MouseRightUp;
+
+	return frame;
+}
+
+//Fields are written one at a time so the stream has no struct padding in it.
+static void WriteInputFrame(const InputFrame& frame)
+{
+	inputRecordStream.write((const char*)&frame.deltaTime, sizeof(frame.deltaTime));
+	inputRecordStream.write((const char*)&frame.keysHeld, sizeof(frame.keysHeld));
+	inputRecordStream.write((const char*)&frame.keysDown, sizeof(frame.keysDown));
+	inputRecordStream.write((const char*)&frame.keysUp, sizeof(frame.keysUp));
+	inputRecordStream.write((const char*)&frame.mouse, sizeof(frame.mouse));
+	inputRecordStream.write((const char*)&frame.cameraRotation, sizeof(frame.cameraRotation));
+	inputRecordStream.write((const char*)&frame.simSteps, sizeof(frame.simSteps));
+}
+
+static bool ReadInputFrame(InputFrame& frame)
+{
+	inputReplayStream.read((char*)&frame.deltaTime, sizeof(frame.deltaTime));
+	inputReplayStream.read((char*)&frame.keysHeld, sizeof(frame.keysHeld));
+	inputReplayStream.read((char*)&frame.keysDown, sizeof(frame.keysDown));
+	inputReplayStream.read((char*)&frame.keysUp, sizeof(frame.keysUp));
+	inputReplayStream.read((char*)&frame.mouse, sizeof(frame.mouse));
+	inputReplayStream.read((char*)&frame.cameraRotation, sizeof(frame.cameraRotation));
+	inputReplayStream.read((char*)&frame.simSteps, sizeof(frame.simSteps));
+	return (bool)inputReplayStream;
+}
+
+float GameInput::BeginFrame(float deltaTime, SpatialComponent* camera)
+{
+	if (recordFramePending)
+	{
+		WriteInputFrame(currentInputFrame);
+		recordFramePending = false;
+	}
+
+	if (IsReplaying())
+	{
+		if (ReadInputFrame(currentInputFrame))
+		{
+			//Overrides this frame's mouse look before anything reads the camera.
+			if (camera)
+			{
+				camera->SetRotation(XMLoadFloat4(&currentInputFrame.cameraRotation));
+			}
+
+			return currentInputFrame.deltaTime;
+		}
+
+		Log("Input replay finished.");
+		inputReplayStream.close();
+	}
+
+	currentInputFrame = SampleLiveInput(deltaTime, camera);
+	recordFramePending = inputRecordStream.is_open();
+
+	return deltaTime;
+}
+
+int GameInput::AdvanceTimestep(FixedTimestep& timestep, float deltaTime)
+{
+	if (IsReplaying())
+	{
+		timestep.tickRate = replayTickRate;
+		//Still advanced so interpolation has an alpha to work with, only the step count is overridden.
+		timestep.Advance(deltaTime);
+		return currentInputFrame.simSteps;
+	}
+
+	const int stepCount = timestep.Advance(deltaTime);
+	currentInputFrame.simSteps = (uint8_t)stepCount;
+	return stepCount;
+}
+
+bool GameInput::GetKeyHeld(Keys key)
+{
+	const int index = FindRecordedKey(key);
+	if (index < 0) return Input::GetKeyHeld(key);
+	return currentInputFrame.keysHeld & (1 << index);
+}
+
+bool GameInput::GetKeyDown(Keys key)
+{
+	const int index = FindRecordedKey(key);
+	if (index < 0) return Input::GetKeyDown(key);
+	return currentInputFrame.keysDown & (1 << index);
+}
+
+bool GameInput::GetKeyUp(Keys key)
+{
+	const int index = FindRecordedKey(key);
+	if (index < 0) return Input::GetKeyUp(key);
+	return currentInputFrame.keysUp & (1 << index);
+}
+
+bool GameInput::GetMouseLeftUp()
+{
+	return currentInputFrame.mouse & MouseLeftUp;
+}
+
+bool GameInput::GetMouseRightUp()
+{
+	return currentInputFrame.mouse & MouseRightUp;
+}
+
+bool GameInput::StartRecording(const std::string& filename, float simTickRate)
+{
+	StopRecording();
+
+	inputRecordStream.open(filename, std::ios::binary | std::ios::trunc);
+	if (!inputRecordStream.is_open())
+	{
+		Log("Couldn't open [%s] to record input to.", filename.c_str());
+		return false;
+	}
+
+	inputRecordStream.write((const char*)&inputStreamMagic, sizeof(inputStreamMagic));
+	inputRecordStream.write((const char*)&inputStreamVersion, sizeof(inputStreamVersion));
+	inputRecordStream.write((const char*)&simTickRate, sizeof(simTickRate));
+
+	Log("Recording input to [%s].", filename.c_str());
+	return true;
+}
+
+void GameInput::StopRecording()
+{
+	if (!inputRecordStream.is_open()) return;
+
+	if (recordFramePending)
+	{
+		WriteInputFrame(currentInputFrame);
+		recordFramePending = false;
+	}
+
+	inputRecordStream.close();
+	Log("Input recording stopped.");
+}
+
+void GameInput::StopReplay()
+{
+	inputReplayStream.close();
+}
+
+bool GameInput::StartReplay(const std::string& filename)
+{
+	inputReplayStream.close();
+	inputReplayStream.clear();
+	inputReplayStream.open(filename, std::ios::binary);
+	if (!inputReplayStream.is_open())
+	{
+		Log("Couldn't open input replay [%s].", filename.c_str());
+		return false;
+	}
+
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	inputReplayStream.read((char*)&magic, sizeof(magic));
+	inputReplayStream.read((char*)&version, sizeof(version));
+	inputReplayStream.read((char*)&replayTickRate, sizeof(replayTickRate));
+	if (magic != inputStreamMagic || version != inputStreamVersion || !(replayTickRate >= minFixedTickRate))
+	{
+		Log("[%s] isn't a version %u input replay.", filename.c_str(), inputStreamVersion);
+		inputReplayStream.close();
+		return false;
+	}
+
+	Log("Replaying input from [%s].", filename.c_str());
+	return true;
+}
+
+bool GameInput::IsReplaying()
+{
+	return inputReplayStream.is_open();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include "Input.h"
+
+struct SpatialComponent;
+class FixedTimestep;
+
+//Gameplay's view of Input. Input is sampled once per frame so whole sessions can be recorded to
+//a compact binary stream and replayed frame for frame, delta time, camera rotation and fixed step
+//counts included, as repeatable benchmarks and regression runs. Every key gameplay reads is recorded, any other
+//key falls through to live Input.
+namespace GameInput
+{
+	//Called first thing in the level driving actor's Tick. Returns the delta time to simulate
+	//the frame with, which is the recorded one during a replay. camera is the driving actor's
+	//camera, its rotation is recorded and set back from the recording during a replay.
+	float BeginFrame(float deltaTime, SpatialComponent* camera);
+
+	//Advances the driving actor's fixed timestep and returns how many steps to simulate. Recorded
+	//with the frame, and a replay runs the recorded count at the recorded tick rate.
+	int AdvanceTimestep(FixedTimestep& timestep, float deltaTime);
+
+	bool GetKeyHeld(Keys key);
+	bool GetKeyDown(Keys key);
+	bool GetKeyUp(Keys key);
+	bool GetMouseLeftUp();
+	bool GetMouseRightUp();
+
+	bool StartRecording(const std::string& filename, float simTickRate);
+	//Writes out the last frame and closes the stream. Called when the level is torn down.
+	void StopRecording();
+
+	//Live input is ignored until the replay runs out of frames.
+	bool StartReplay(const std::string& filename);
+	void StopReplay();
+	bool IsReplaying();
+}
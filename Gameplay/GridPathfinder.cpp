@@ -0,0 +1,194 @@
+#include "vpch.h"
+#include "GridPathfinder.h"
+#include <algorithm>
+#include <cstdlib>
+#include <unordered_map>
+#include "OccupancyGrid.h"
+#include "Profiler.h"
+
+const XMINT3 pathNeighbours[6] =
+{
+	{ 1, 0, 0 }, { -1, 0, 0 },
+	{ 0, 1, 0 }, { 0, -1, 0 },
+	{ 0, 0, 1 }, { 0, 0, -1 },
+};
+
+//Cap on cached paths, dozens of enemies each chasing the player only need a handful per turn.
+const size_t maxCachedPaths = 256;
+
+struct PathNode
+{
+	int cellIndex;
+	int fScore;
+};
+
+struct CachedPath
+{
+	int maxSteps;
+	GridPathfinder::PathResult result;
+};
+
+//Per cell search state, reused across queries. A cell's entries are only valid if its
+//searchStamp matches the current search, which saves clearing them between queries.
+std::vector<uint32_t> searchStamp;
+std::vector<uint16_t> stepsFromStart;
+std::vector<int> cameFrom;
+std::vector<uint8_t> closed;
+std::vector<PathNode> openHeap;
+uint32_t currentSearch = 0;
+
+std::unordered_map<uint64_t, CachedPath> pathCache;
+uint32_t pathCacheGridVersion = 0;
+
+static int ManhattanDistance(XMINT3 a, XMINT3 b)
+{
+	return std::abs(a.x - b.x) + std::abs(a.y - b.y) + std::abs(a.z - b.z);
+}
+
+static bool CompareOpenNodes(const PathNode& a, const PathNode& b)
+{
+	//std heap functions build a max heap, flip it for lowest f first.
+	return a.fScore > b.fScore;
+}
+
+static void PrepareSearchBuffers()
+{
+	const size_t cellCount = OccupancyGrid::GetCellCount();
+	if (searchStamp.size() != cellCount)
+	{
+		searchStamp.assign(cellCount, 0);
+		stepsFromStart.resize(cellCount);
+		cameFrom.resize(cellCount);
+		closed.resize(cellCount);
+		currentSearch = 0;
+	}
+
+	currentSearch++;
+	openHeap.clear();
+}
+
+static void RunSearch(XMINT3 start, XMINT3 goal, int maxSteps, GridPathfinder::PathResult& result)
+{
+	result.reachedGoal = false;
+	result.path.clear();
+
+	const int startIndex = OccupancyGrid::CellToIndex(start);
+	const int goalIndex = OccupancyGrid::CellToIndex(goal);
+	if (startIndex < 0 || goalIndex < 0) return;
+
+	PrepareSearchBuffers();
+
+	searchStamp[startIndex] = currentSearch;
+	stepsFromStart[startIndex] = 0;
+	cameFrom[startIndex] = -1;
+	closed[startIndex] = false;
+	openHeap.push_back({ startIndex, ManhattanDistance(start, goal) });
+
+	int closestIndex = startIndex;
+	int closestDistance = ManhattanDistance(start, goal);
+
+	while (!openHeap.empty())
+	{
+		std::pop_heap(openHeap.begin(), openHeap.end(), CompareOpenNodes);
+		const int currentIndex = openHeap.back().cellIndex;
+		openHeap.pop_back();
+
+		if (closed[currentIndex]) continue;
+		closed[currentIndex] = true;
+
+		if (currentIndex == goalIndex)
+		{
+			closestIndex = goalIndex;
+			result.reachedGoal = true;
+			break;
+		}
+
+		const XMINT3 current = OccupancyGrid::IndexToCell(currentIndex);
+		const int distanceToGoal = ManhattanDistance(current, goal);
+		if (distanceToGoal < closestDistance)
+		{
+			closestDistance = distanceToGoal;
+			closestIndex = currentIndex;
+		}
+
+		const int nextSteps = stepsFromStart[currentIndex] + 1;
+		if (nextSteps > maxSteps) continue;
+
+		for (const XMINT3& offset : pathNeighbours)
+		{
+			const XMINT3 neighbour(current.x + offset.x, current.y + offset.y, current.z + offset.z);
+
+			//The goal is usually the player, who stands on a floor cell, but let it through regardless.
+			const int neighbourIndex = OccupancyGrid::CellToIndex(neighbour);
+			if (neighbourIndex < 0) continue;
+			if (neighbourIndex != goalIndex && !GridPathfinder::IsWalkable(neighbour)) continue;
+
+			if (searchStamp[neighbourIndex] != currentSearch)
+			{
+				searchStamp[neighbourIndex] = currentSearch;
+				closed[neighbourIndex] = false;
+			}
+			else if (closed[neighbourIndex] || stepsFromStart[neighbourIndex] <= nextSteps)
+			{
+				continue;
+			}
+
+			stepsFromStart[neighbourIndex] = (uint16_t)nextSteps;
+			cameFrom[neighbourIndex] = currentIndex;
+
+			openHeap.push_back({ neighbourIndex, nextSteps + ManhattanDistance(neighbour, goal) });
+			std::push_heap(openHeap.begin(), openHeap.end(), CompareOpenNodes);
+		}
+	}
+
+	for (int index = closestIndex; index != startIndex; index = cameFrom[index])
+	{
+		result.path.push_back(OccupancyGrid::IndexToCell(index));
+	}
+	std::reverse(result.path.begin(), result.path.end());
+}
+
+const GridPathfinder::PathResult& GridPathfinder::FindPath(XMINT3 start, XMINT3 goal, int maxSteps)
+{
+	PROFILE_FUNCTION();
+
+	if (pathCacheGridVersion != OccupancyGrid::GetVersion())
+	{
+		pathCache.clear();
+		pathCacheGridVersion = OccupancyGrid::GetVersion();
+	}
+
+	const uint64_t key = (uint64_t)(uint32_t)OccupancyGrid::CellToIndex(start) |
+		((uint64_t)(uint32_t)OccupancyGrid::CellToIndex(goal) << 32);
+
+	auto cacheIt = pathCache.find(key);
+	if (cacheIt != pathCache.end() && cacheIt->second.maxSteps == maxSteps)
+	{
+		return cacheIt->second.result;
+	}
+
+	if (pathCache.size() >= maxCachedPaths)
+	{
+		pathCache.clear();
+	}
+
+	CachedPath& cachedPath = pathCache[key];
+	cachedPath.maxSteps = maxSteps;
+	RunSearch(start, goal, maxSteps, cachedPath.result);
+	return cachedPath.result;
+}
+
+bool GridPathfinder::IsWalkable(XMINT3 cell)
+{
+	return OccupancyGrid::GetCellFlags(cell) & OccupancyGrid::Floor;
+}
+
+void GridPathfinder::Reset()
+{
+	pathCache.clear();
+	searchStamp.clear();
+	stepsFromStart.clear();
+	cameFrom.clear();
+	closed.clear();
+	openHeap.clear();
+}
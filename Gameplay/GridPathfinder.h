@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+//A* over the OccupancyGrid's floor cells (walls and ceilings included) for enemy combat turns.
+//Every step costs one action point. Search buffers are kept between queries and sized to the
+//level, so finding a path doesn't allocate once warmed up.
+namespace GridPathfinder
+{
+	struct PathResult
+	{
+		//False when the goal is out of reach or further than maxSteps. The path then leads to
+		//the reachable cell closest to the goal instead.
+		bool reachedGoal = false;
+
+		//Cells to step through in order, excluding the start cell.
+		std::vector<XMINT3> path;
+	};
+
+	//Results are cached per start, goal and budget until the grid changes (e.g. a door opens).
+	//The returned reference is only valid until the next call.
+	const PathResult& FindPath(XMINT3 start, XMINT3 goal, int maxSteps);
+
+	bool IsWalkable(XMINT3 cell);
+
+	void Reset();
+}
@@ -0,0 +1,389 @@
+#include "vpch.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "DebugCommands.h"
+#include "Profiler.h"
+
+struct JobQueue
+{
+	std::mutex mutex;
+	std::deque<JobSystem::Job> jobs;
+};
+
+//Queue 0 belongs to the game thread, the rest to one worker thread each.
+class JobWorkers
+{
+public:
+	JobWorkers()
+	{
+		const int threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+		for (int i = 0; i < threadCount; i++)
+		{
+			queues.push_back(std::make_unique<JobQueue>());
+		}
+
+		running = true;
+		for (int i = 1; i < threadCount; i++)
+		{
+			threads.emplace_back(&JobWorkers::WorkerLoop, this, i);
+		}
+	}
+
+	~JobWorkers()
+	{
+		{
+			std::lock_guard<std::mutex> lock(wakeMutex);
+			running = false;
+		}
+		wakeCondition.notify_all();
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	void Push(JobSystem::Job job, int queueIndex)
+	{
+		{
+			std::lock_guard<std::mutex> lock(queues[queueIndex]->mutex);
+			queues[queueIndex]->jobs.push_back(std::move(job));
+		}
+
+		{
+			//Under the wake mutex so a worker can't miss this between checking for work and sleeping.
+			std::lock_guard<std::mutex> lock(wakeMutex);
+			pendingJobs++;
+		}
+		wakeCondition.notify_one();
+	}
+
+	bool TryRunJob(int queueIndex)
+	{
+		JobSystem::Job job;
+		if (PopOwnJob(queueIndex, job) || StealJob(queueIndex, job))
+		{
+			pendingJobs--;
+			job();
+			return true;
+		}
+
+		return false;
+	}
+
+	int GetQueueCount() { return (int)queues.size(); }
+
+private:
+	//Owner takes from the back (most recently pushed, still hot in cache), thieves from the front.
+	bool PopOwnJob(int queueIndex, JobSystem::Job& job)
+	{
+		JobQueue& queue = *queues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.jobs.empty()) return false;
+
+		job = std::move(queue.jobs.back());
+		queue.jobs.pop_back();
+		return true;
+	}
+
+	bool StealJob(int thiefIndex, JobSystem::Job& job)
+	{
+		for (int offset = 1; offset < (int)queues.size(); offset++)
+		{
+			JobQueue& queue = *queues[(thiefIndex + offset) % queues.size()];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.jobs.empty()) continue;
+
+			job = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+			return true;
+		}
+
+		return false;
+	}
+
+	void WorkerLoop(int queueIndex);
+
+	std::vector<std::unique_ptr<JobQueue>> queues;
+	std::vector<std::thread> threads;
+
+	std::mutex wakeMutex;
+	std::condition_variable wakeCondition;
+	std::atomic<int> pendingJobs{ 0 };
+	bool running = false;
+};
+
+//Which queue the current thread owns. The game thread and any other thread not started by
+//the job system use queue 0.
+thread_local int jobQueueIndex = 0;
+
+void JobWorkers::WorkerLoop(int queueIndex)
+{
+	jobQueueIndex = queueIndex;
+
+	while (true)
+	{
+		if (TryRunJob(queueIndex)) continue;
+
+		std::unique_lock<std::mutex> lock(wakeMutex);
+		wakeCondition.wait(lock, [this]() { return pendingJobs > 0 || !running; });
+		if (!running) return;
+	}
+}
+
+static JobWorkers& GetJobWorkers()
+{
+	//Started on first use so levels without parallel work never spin up threads.
+	static JobWorkers workers;
+	return workers;
+}
+
+std::mutex deferredMutex;
+std::vector<JobSystem::Job> deferredWorldMutations;
+
+//Threads without a queue of their own spread their jobs across every queue, workers push to their own.
+//Atomic as the game thread isn't the only thread without a queue, async file work runs Jobs too.
+std::atomic<unsigned> nextJobQueue{ 0 };
+
+void JobSystem::Run(Job job, JobCounter& counter)
+{
+	JobWorkers& workers = GetJobWorkers();
+
+	counter.remaining++;
+
+	int queueIndex = jobQueueIndex;
+	if (queueIndex == 0)
+	{
+		queueIndex = (int)(nextJobQueue.fetch_add(1, std::memory_order_relaxed) % workers.GetQueueCount());
+	}
+
+	workers.Push([job = std::move(job), &counter]() {
+		{
+			PROFILE_ZONE("Job");
+			job();
+		}
+		counter.remaining--;
+	}, queueIndex);
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+	JobWorkers& workers = GetJobWorkers();
+
+	while (counter.remaining > 0)
+	{
+		if (!workers.TryRunJob(jobQueueIndex))
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::ParallelFor(int count, int chunkSize, const std::function<void(int start, int end)>& func)
+{
+	if (count <= 0) return;
+
+	//Not worth the hand off for a single chunk.
+	if (count <= chunkSize)
+	{
+		func(0, count);
+		return;
+	}
+
+	JobCounter counter;
+	for (int start = 0; start < count; start += chunkSize)
+	{
+		const int end = std::min(start + chunkSize, count);
+		Run([&func, start, end]() { func(start, end); }, counter);
+	}
+
+	Wait(counter);
+}
+
+static bool Contains(const std::vector<JobSystem::SystemResource>& resources, JobSystem::SystemResource resource)
+{
+	return std::find(resources.begin(), resources.end(), resource) != resources.end();
+}
+
+static bool TasksConflict(const JobSystem::SystemTask& a, const JobSystem::SystemTask& b)
+{
+	for (JobSystem::SystemResource written : a.writes)
+	{
+		if (Contains(b.reads, written) || Contains(b.writes, written)) return true;
+	}
+
+	for (JobSystem::SystemResource written : b.writes)
+	{
+		if (Contains(a.reads, written)) return true;
+	}
+
+	return false;
+}
+
+void JobSystem::RunSystemTasks(const std::vector<SystemTask>& tasks)
+{
+	PROFILE_FUNCTION();
+
+	//A handful of tasks a frame, pairwise checks are cheaper than building anything smarter.
+	std::vector<int> taskWaves(tasks.size(), 0);
+	int waveCount = 0;
+	for (size_t i = 0; i < tasks.size(); i++)
+	{
+		for (size_t earlier = 0; earlier < i; earlier++)
+		{
+			if (TasksConflict(tasks[i], tasks[earlier]))
+			{
+				taskWaves[i] = std::max(taskWaves[i], taskWaves[earlier] + 1);
+			}
+		}
+		waveCount = std::max(waveCount, taskWaves[i] + 1);
+	}
+
+	for (int wave = 0; wave < waveCount; wave++)
+	{
+		JobCounter counter;
+		for (size_t i = 0; i < tasks.size(); i++)
+		{
+			if (taskWaves[i] != wave) continue;
+
+			const SystemTask& task = tasks[i];
+			Run([&task]() {
+				PROFILE_ZONE(task.name);
+				task.run();
+			}, counter);
+		}
+
+		Wait(counter);
+	}
+}
+
+void JobSystem::Defer(Job worldMutation)
+{
+	std::lock_guard<std::mutex> lock(deferredMutex);
+	deferredWorldMutations.push_back(std::move(worldMutation));
+}
+
+void JobSystem::FlushDeferred()
+{
+	std::vector<Job> mutations;
+	{
+		std::lock_guard<std::mutex> lock(deferredMutex);
+		mutations.swap(deferredWorldMutations);
+	}
+
+	for (Job& mutation : mutations)
+	{
+		mutation();
+	}
+}
+
+int JobSystem::GetWorkerCount()
+{
+	return GetJobWorkers().GetQueueCount();
+}
+
+//Stand-in work for the benchmark. Pure ALU so it measures the scheduler rather than memory bandwidth.
+static uint32_t HashJobItem(uint32_t value)
+{
+	for (int round = 0; round < 64; round++)
+	{
+		value ^= value << 13;
+		value ^= value >> 17;
+		value ^= value << 5;
+	}
+	return value;
+}
+
+//Splits a fixed workload into as many jobs as threads being measured, from one up to every queue, and
+//logs the time and speedup over one thread for each. Fails if any run's result is off.
+static DebugCommands::Registration jobScalingCommand("JobSystemScaling", []() {
+	const int itemCount = 1 << 20;
+
+	uint64_t expectedSum = 0;
+	for (int i = 0; i < itemCount; i++)
+	{
+		expectedSum += HashJobItem(i + 1);
+	}
+
+	bool passed = true;
+	double oneThreadMs = 0.0;
+
+	for (int threadCount = 1; threadCount <= JobSystem::GetWorkerCount(); threadCount++)
+	{
+		const int chunkSize = (itemCount + threadCount - 1) / threadCount;
+		std::vector<uint64_t> chunkSums(threadCount, 0);
+
+		const auto startTime = std::chrono::steady_clock::now();
+		JobSystem::ParallelFor(itemCount, chunkSize, [&chunkSums, chunkSize](int start, int end) {
+			uint64_t sum = 0;
+			for (int i = start; i < end; i++)
+			{
+				sum += HashJobItem(i + 1);
+			}
+			chunkSums[start / chunkSize] = sum;
+		});
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+		uint64_t sum = 0;
+		for (uint64_t chunkSum : chunkSums) sum += chunkSum;
+
+		if (threadCount == 1) oneThreadMs = ms;
+
+		Log("JobSystem %d thread(s): %.2fms, %.2fx.", threadCount, ms, ms > 0.0 ? oneThreadMs / ms : 0.0);
+
+		if (sum != expectedSum)
+		{
+			Log("JobSystem %d thread(s) summed to %llu, expected %llu.", threadCount, sum, expectedSum);
+			passed = false;
+		}
+	}
+
+	return passed;
+});
+
+//Read after write, write after read and write after write between tasks must keep their order,
+//and a task with nothing in common with the others must still run.
+static DebugCommands::Registration systemTaskOrderCommand("JobSystemTaskOrder", []() {
+	int a = 0, b = 0, c = 0;
+	std::atomic<int> nextStamp{ 0 };
+	int writeStamp = -1, readStamp = -1, overwriteStamp = -1;
+
+	JobSystem::SystemTask write;
+	write.name = "Write A";
+	write.writes = { &a };
+	write.run = [&]() { a = 1; writeStamp = nextStamp++; };
+
+	JobSystem::SystemTask read;
+	read.name = "Read A Write B";
+	read.reads = { &a };
+	read.writes = { &b };
+	read.run = [&]() { b = a + 1; readStamp = nextStamp++; };
+
+	JobSystem::SystemTask overwrite;
+	overwrite.name = "Overwrite A";
+	overwrite.writes = { &a };
+	overwrite.run = [&]() { a = 10; overwriteStamp = nextStamp++; };
+
+	JobSystem::SystemTask independent;
+	independent.name = "Write C";
+	independent.writes = { &c };
+	independent.run = [&]() { c = 1; nextStamp++; };
+
+	JobSystem::RunSystemTasks({ write, read, overwrite, independent });
+
+	const bool passed = a == 10 && b == 2 && c == 1 && writeStamp < readStamp && readStamp < overwriteStamp;
+	if (!passed)
+	{
+		Log("System tasks ran out of order: a %d, b %d, c %d, stamps %d %d %d.", a, b, c,
+			writeStamp, readStamp, overwriteStamp);
+	}
+	return passed;
+});
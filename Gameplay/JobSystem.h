@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+//Work-stealing job scheduler. Each worker owns a job queue and steals from the others when its
+//own runs dry. Threads waiting on jobs help run them instead of blocking.
+namespace JobSystem
+{
+	using Job = std::function<void()>;
+
+	//Tracks a group of jobs. Wait() on it returns once every job run against it has finished.
+	struct JobCounter
+	{
+		std::atomic<int> remaining{ 0 };
+	};
+
+	void Run(Job job, JobCounter& counter);
+	void Wait(JobCounter& counter);
+
+	//Splits [0, count) into chunks of chunkSize and runs func(start, end) on each in parallel.
+	//Returns once every chunk is done.
+	void ParallelFor(int count, int chunkSize, const std::function<void(int start, int end)>& func);
+
+	//Data a SystemTask touches, the address of whatever the owning system stores it in.
+	using SystemResource = const void*;
+
+	//One system's share of a frame's work, with the data it reads and writes declared up front.
+	//Tasks only run with each other when none of them writes data another reads or writes.
+	struct SystemTask
+	{
+		const char* name = "";
+		std::vector<SystemResource> reads;
+		std::vector<SystemResource> writes;
+		Job run;
+	};
+
+	//Runs tasks in waves. A task goes in the wave after the last earlier task it conflicts with,
+	//so conflicting tasks keep the order they're passed in and everything else runs in parallel.
+	//Returns once every task is done. Tasks must not touch the world, Defer() that instead.
+	void RunSystemTasks(const std::vector<SystemTask>& tasks);
+
+	//Queues a change to the world (Destroy(), system.Add() and the like) to run at the next sync
+	//point, so nothing mutates the world while jobs might still be reading it.
+	void Defer(Job worldMutation);
+
+	//Runs deferred world mutations. Game thread only, once no jobs are in flight.
+	void FlushDeferred();
+
+	int GetWorkerCount();
+}
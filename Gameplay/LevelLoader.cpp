@@ -0,0 +1,160 @@
+#include "vpch.h"
+#include "LevelLoader.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <vector>
+#include "FileSystem.h"
+#include "Asset/AssetBaseFolders.h"
+#include "TriggerBroadphase.h"
+#include "ActorRef.h"
+#include "EnemySimulation.h"
+#include "JobSystem.h"
+#include "GridPathfinder.h"
+#include "FlowField.h"
+#include "OverworldStreaming.h"
+#include "WorldWidgets.h"
+#include "NotePool.h"
+#include "SaveSnapshot.h"
+#include "UI/Game/UIDrawList.h"
+#include "DialogueCache.h"
+#include "GameInput.h"
+#include "Profiler.h"
+
+using LevelLoadClock = std::chrono::steady_clock;
+
+std::string warmLevelName;
+std::future<double> warmFuture;
+std::shared_ptr<std::atomic<bool>> warmCancelled;
+
+//Warms replaced by one for another level. Cancelled and left to wind down on their worker,
+//a future from std::async blocks in its destructor so they're only dropped once ready.
+std::vector<std::future<double>> staleWarms;
+
+std::string pendingLevelName;
+std::string currentLevelName;
+LevelLoadClock::time_point loadRequestTime;
+
+LevelLoader::LevelLoadTimings lastLoadTimings;
+
+static double ElapsedMs(LevelLoadClock::time_point start, LevelLoadClock::time_point end)
+{
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+//Reading the whole file pulls it into the OS file cache so LoadWorld's own read doesn't touch the disk.
+//Nothing read is kept. Checks for cancellation between chunks.
+static double WarmLevelFile(std::string path, std::shared_ptr<std::atomic<bool>> cancelled)
+{
+	const auto start = LevelLoadClock::now();
+
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open())
+	{
+		Log("Couldn't open level file [%s] to warm the file cache with.", path.c_str());
+		return 0.0;
+	}
+
+	std::vector<char> buffer(64 * 1024);
+	while (!cancelled->load(std::memory_order_relaxed) &&
+		(file.read(buffer.data(), buffer.size()) || file.gcount() > 0)) {}
+
+	return ElapsedMs(start, LevelLoadClock::now());
+}
+
+void LevelLoader::WarmFileCache(const std::string& levelName)
+{
+	if (levelName == warmLevelName && warmFuture.valid()) return;
+
+	//Never wait on a warm for another level here, that's the hitch warming is meant to remove.
+	if (warmFuture.valid())
+	{
+		warmCancelled->store(true, std::memory_order_relaxed);
+		staleWarms.push_back(std::move(warmFuture));
+	}
+
+	//Same path LoadWorld reads the level from.
+	warmLevelName = levelName;
+	warmCancelled = std::make_shared<std::atomic<bool>>(false);
+	warmFuture = std::async(std::launch::async, WarmLevelFile, AssetBaseFolders::worldMap + levelName, warmCancelled);
+}
+
+void LevelLoader::RequestLoad(const std::string& levelName)
+{
+	if (IsLoadPending()) return;
+
+	WarmFileCache(levelName);
+
+	pendingLevelName = levelName;
+	loadRequestTime = LevelLoadClock::now();
+}
+
+void LevelLoader::Update()
+{
+	PROFILE_FUNCTION();
+
+	staleWarms.erase(std::remove_if(staleWarms.begin(), staleWarms.end(),
+		[](std::future<double>& stale) { return stale.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }),
+		staleWarms.end());
+
+	if (!IsLoadPending()) return;
+
+	if (warmFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+
+	const auto warmDone = LevelLoadClock::now();
+
+	lastLoadTimings = LevelLoadTimings();
+	lastLoadTimings.levelName = pendingLevelName;
+	lastLoadTimings.cacheWarmMs = warmFuture.get();
+	lastLoadTimings.waitMs = ElapsedMs(loadRequestTime, warmDone);
+
+	const std::string levelName = pendingLevelName;
+	pendingLevelName.clear();
+	warmLevelName.clear();
+
+	//Recordings and replays are of one level, the next level's Player starts its own.
+	GameInput::StopRecording();
+	GameInput::StopReplay();
+
+	//Triggers, refs and enemies belong to the world being unloaded.
+	JobSystem::FlushDeferred();
+	TriggerBroadphase::Reset();
+	ActorRefs::Reset();
+	EnemySimulation::Reset();
+	GridPathfinder::Reset();
+	FlowField::Reset();
+	OverworldStreaming::Reset();
+	WorldWidgets::Reset();
+	NotePool::Reset();
+	SaveSnapshot::Reset();
+	//The level driving actor recording it is going.
+	UIDrawList::Reset();
+	//The next level prefetches its own dialogue as its triggers start.
+	DialogueCache::Clear();
+
+	FileSystem::LoadWorld(levelName);
+	currentLevelName = levelName;
+
+	lastLoadTimings.loadWorldMs = ElapsedMs(warmDone, LevelLoadClock::now());
+
+	Log("Level [%s] loaded. Cache warm: %.2fms, wait: %.2fms, load: %.2fms", levelName.c_str(),
+		lastLoadTimings.cacheWarmMs, lastLoadTimings.waitMs, lastLoadTimings.loadWorldMs);
+}
+
+bool LevelLoader::IsLoadPending()
+{
+	return !pendingLevelName.empty();
+}
+
+const std::string& LevelLoader::GetCurrentLevelName()
+{
+	return currentLevelName;
+}
+
+LevelLoader::LevelLoadTimings LevelLoader::GetLastLoadTimings()
+{
+	return lastLoadTimings;
+}
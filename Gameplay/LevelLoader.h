@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+
+//Warms the OS file cache with a level's file on a worker thread ahead of the player asking to enter
+//it, then swaps the world in on a later frame once the read is done. FileSystem::LoadWorld itself
+//still parses and builds the world synchronously on the game thread. Warming only takes the disk
+//read out of that frame.
+namespace LevelLoader
+{
+	struct LevelLoadTimings
+	{
+		std::string levelName;
+		//Time the worker spent reading the level file into the OS cache.
+		double cacheWarmMs = 0.0;
+		//Time between the load being requested and the cache warm finishing. Zero if it was already done.
+		double waitMs = 0.0;
+		//Time spent in FileSystem::LoadWorld on the game thread.
+		double loadWorldMs = 0.0;
+	};
+
+	//Starts reading the level's file on a worker thread. Safe to call repeatedly for the same level.
+	void WarmFileCache(const std::string& levelName);
+
+	//Queues the level to be swapped in by Update() once its file cache warm has finished.
+	void RequestLoad(const std::string& levelName);
+
+	//Called once a frame. Loads the requested level once its file is ready.
+	void Update();
+
+	bool IsLoadPending();
+
+	//The level LevelLoader last swapped in. Empty for the level the game started in.
+	const std::string& GetCurrentLevelName();
+
+	LevelLoadTimings GetLastLoadTimings();
+}
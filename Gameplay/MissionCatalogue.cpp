@@ -0,0 +1,185 @@
+#include "vpch.h"
+#include "MissionCatalogue.h"
+#include <algorithm>
+#include <unordered_map>
+#include "VString.h"
+#include "Profiler.h"
+#include "Gameplay/MissionSystem.h"
+#include "Gameplay/Mission.h"
+
+std::vector<MissionEntry> missionTable;
+std::unordered_map<std::wstring, MissionID> missionIDsByName;
+std::vector<std::wstring> missionClients;
+
+//Bumped on every add so cached queries know they're stale.
+uint32_t missionCatalogueVersion = 0;
+
+struct MissionQueryCache
+{
+	std::vector<MissionID> results;
+	std::wstring clientFilter;
+	MissionSortOrder order = MissionSortOrder::RewardHighToLow;
+	uint32_t catalogueVersion = UINT32_MAX;
+};
+
+MissionQueryCache missionQueryCache;
+
+const wchar_t* generatedContractClients[] =
+{
+	L"Orbital Reclamation Co.",
+	L"Deepwater Holdings",
+	L"Helix Freight",
+	L"The Archivists",
+	L"Marrow & Sons",
+	L"Independent",
+};
+
+const wchar_t* generatedContractWrecks[] =
+{
+	L"Hauler", L"Dredger", L"Survey Drone", L"Tanker", L"Research Station", L"Ferry",
+};
+
+void MissionCatalogue::LoadMissions(int generatedContractCount)
+{
+	PROFILE_FUNCTION();
+
+	Clear();
+
+	if (Mission* testMission = MissionSystem::FindMission(L"Test Mission"))
+	{
+		Add(testMission->name, L"Independent", 100, testMission->details);
+	}
+
+	AddGeneratedContracts(generatedContractCount, 1);
+}
+
+MissionID MissionCatalogue::Add(const std::wstring& name, const std::wstring& client, int reward, const std::wstring& details)
+{
+	if (missionIDsByName.find(name) != missionIDsByName.end())
+	{
+		Log("Mission [%s] already in catalogue.", VString::wstos(name).c_str());
+		return INVALID_MISSION_ID;
+	}
+
+	const MissionID id = (MissionID)missionTable.size();
+
+	MissionEntry entry;
+	entry.id = id;
+	entry.name = name;
+	entry.client = client;
+	entry.details = details;
+	entry.reward = reward;
+	entry.listLabel = name + L"  |  " + client + L"  |  " + std::to_wstring(reward) + L"cr";
+	missionTable.push_back(std::move(entry));
+
+	missionIDsByName.emplace(name, id);
+
+	if (std::find(missionClients.begin(), missionClients.end(), client) == missionClients.end())
+	{
+		missionClients.push_back(client);
+	}
+
+	missionCatalogueVersion++;
+
+	return id;
+}
+
+void MissionCatalogue::AddGeneratedContracts(int count, uint32_t seed)
+{
+	const int clientCount = sizeof(generatedContractClients) / sizeof(generatedContractClients[0]);
+	const int wreckCount = sizeof(generatedContractWrecks) / sizeof(generatedContractWrecks[0]);
+
+	missionTable.reserve(missionTable.size() + count);
+
+	//LCG so the same seed always produces the same contracts.
+	uint32_t state = seed;
+	auto next = [&state]() {
+		state = state * 1664525u + 1013904223u;
+		return state >> 8;
+	};
+
+	for (int i = 0; i < count; i++)
+	{
+		const std::wstring client = generatedContractClients[next() % clientCount];
+		const std::wstring wreck = generatedContractWrecks[next() % wreckCount];
+		const int reward = 50 + (int)(next() % 100) * 50;
+
+		const std::wstring name = wreck + L" Contract " + std::to_wstring(missionTable.size());
+		Add(name, client, reward, L"Recover what you can from the " + wreck + L" for " + client + L".");
+	}
+}
+
+const MissionEntry* MissionCatalogue::Get(MissionID id)
+{
+	if (id >= missionTable.size()) return nullptr;
+	return &missionTable[id];
+}
+
+MissionID MissionCatalogue::FindByName(const std::wstring& name)
+{
+	auto idIt = missionIDsByName.find(name);
+	if (idIt == missionIDsByName.end()) return INVALID_MISSION_ID;
+	return idIt->second;
+}
+
+int MissionCatalogue::GetMissionCount()
+{
+	return (int)missionTable.size();
+}
+
+const std::vector<std::wstring>& MissionCatalogue::GetClients()
+{
+	return missionClients;
+}
+
+const std::vector<MissionID>& MissionCatalogue::Query(MissionSortOrder order, const std::wstring& clientFilter)
+{
+	MissionQueryCache& cache = missionQueryCache;
+	if (cache.catalogueVersion == missionCatalogueVersion && cache.order == order && cache.clientFilter == clientFilter)
+	{
+		return cache.results;
+	}
+
+	PROFILE_FUNCTION();
+
+	cache.catalogueVersion = missionCatalogueVersion;
+	cache.order = order;
+	cache.clientFilter = clientFilter;
+
+	cache.results.clear();
+	for (const MissionEntry& entry : missionTable)
+	{
+		if (clientFilter.empty() || entry.client == clientFilter)
+		{
+			cache.results.push_back(entry.id);
+		}
+	}
+
+	switch (order)
+	{
+	case MissionSortOrder::RewardHighToLow:
+		std::stable_sort(cache.results.begin(), cache.results.end(), [](MissionID a, MissionID b) {
+			return missionTable[a].reward > missionTable[b].reward;
+		});
+		break;
+
+	case MissionSortOrder::ClientThenName:
+		std::sort(cache.results.begin(), cache.results.end(), [](MissionID a, MissionID b) {
+			const MissionEntry& entryA = missionTable[a];
+			const MissionEntry& entryB = missionTable[b];
+			if (entryA.client != entryB.client) return entryA.client < entryB.client;
+			return entryA.name < entryB.name;
+		});
+		break;
+	}
+
+	return cache.results;
+}
+
+void MissionCatalogue::Clear()
+{
+	missionTable.clear();
+	missionIDsByName.clear();
+	missionClients.clear();
+	missionCatalogueVersion++;
+}
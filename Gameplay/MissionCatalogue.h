@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using MissionID = uint32_t;
+
+static const MissionID INVALID_MISSION_ID = UINT32_MAX;
+
+enum class MissionSortOrder
+{
+	RewardHighToLow,
+	ClientThenName,
+};
+
+struct MissionEntry
+{
+	MissionID id = INVALID_MISSION_ID;
+	std::wstring name;
+	std::wstring client;
+	std::wstring details;
+	int reward = 0;
+	//Built once on add so list rows don't format strings every frame.
+	std::wstring listLabel;
+};
+
+//Every mission the ClientSalvageMenu can offer, kept in one contiguous table where a MissionID is
+//the entry's index. Names are hashed for lookups and sorted, client filtered views of the table
+//are cached until the query or catalogue changes.
+namespace MissionCatalogue
+{
+	//Fills the catalogue with MissionSystem's missions plus a number of procedurally generated contracts.
+	void LoadMissions(int generatedContractCount);
+
+	MissionID Add(const std::wstring& name, const std::wstring& client, int reward, const std::wstring& details);
+	void AddGeneratedContracts(int count, uint32_t seed);
+
+	const MissionEntry* Get(MissionID id);
+	MissionID FindByName(const std::wstring& name);
+	int GetMissionCount();
+
+	//Distinct clients in the order they were first added.
+	const std::vector<std::wstring>& GetClients();
+
+	//Mission IDs in sort order. An empty client filter returns every mission.
+	//Valid until the next Query() with different arguments or the catalogue changes.
+	const std::vector<MissionID>& Query(MissionSortOrder order, const std::wstring& clientFilter);
+
+	void Clear();
+}
@@ -0,0 +1,291 @@
+#include "vpch.h"
+#include "NotePool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "Actors/Game/NoteActor.h"
+
+const float noteCellSize = 16.f;
+
+//Cells either side of the viewer's cell to show notes in. Has to reach past the note widget's own
+//cull distance or notes would pop in before WorldWidgets gets a say.
+const int noteShowRadiusCells = 2;
+
+struct NoteCell
+{
+	int x, y, z;
+};
+
+struct NoteSlot
+{
+	NoteActor* actor = nullptr;
+	XMFLOAT3 position = {};
+	XMFLOAT4 rotation = {};
+	uint64_t cellKey = 0;
+	int textLength = 0;
+	uint32_t nearbyStamp = 0;
+	bool nearby = false;
+};
+
+std::vector<NoteSlot> noteSlots;
+
+//maxNoteTextLength characters per slot, allocated once in Init. Shared with save snapshots, see
+//NotePool::Snapshot().
+std::shared_ptr<std::vector<wchar_t>> noteTextArena;
+
+std::unordered_map<uint64_t, std::vector<int>> noteCells;
+
+//Slots whose widgets are currently handed to WorldWidgets.
+std::vector<int> nearbyNoteSlots;
+std::vector<int> previousNearbyNoteSlots;
+
+//Next slot to place into. Once every slot is used it always points at the oldest note.
+int nextNoteSlot = 0;
+int placedNoteCount = 0;
+
+uint64_t lastViewerNoteCell = UINT64_MAX;
+uint32_t noteNearbyStamp = 0;
+bool noteCellsDirty = false;
+
+static NoteCell PositionToNoteCell(XMFLOAT3 pos)
+{
+	return { (int)std::floor(pos.x / noteCellSize),
+		(int)std::floor(pos.y / noteCellSize),
+		(int)std::floor(pos.z / noteCellSize) };
+}
+
+static uint64_t HashNoteCell(NoteCell cell)
+{
+	const uint64_t mask = (1ull << 21) - 1;
+	return ((uint64_t)cell.x & mask) | (((uint64_t)cell.y & mask) << 21) | (((uint64_t)cell.z & mask) << 42);
+}
+
+static NoteActor* GetOrCreateNoteActor(NoteSlot& slot)
+{
+	if (slot.actor == nullptr)
+	{
+		slot.actor = NoteActor::system.Add(NoteActor(), Transform());
+	}
+	return slot.actor;
+}
+
+static void HideNoteSlot(int slotIndex)
+{
+	NoteSlot& slot = noteSlots[slotIndex];
+	if (!slot.nearby) return;
+
+	slot.actor->RemoveNoteWidgetFromViewport();
+	slot.nearby = false;
+}
+
+static void RemoveFromNoteCell(int slotIndex)
+{
+	auto cellIt = noteCells.find(noteSlots[slotIndex].cellKey);
+	if (cellIt == noteCells.end()) return;
+
+	std::vector<int>& cellSlots = cellIt->second;
+	cellSlots.erase(std::remove(cellSlots.begin(), cellSlots.end(), slotIndex), cellSlots.end());
+	if (cellSlots.empty())
+	{
+		noteCells.erase(cellIt);
+	}
+}
+
+void NotePool::Init(int maxNotes)
+{
+	Reset();
+
+	maxNotes = std::max(maxNotes, 1);
+	noteSlots.resize(maxNotes);
+	noteTextArena = std::make_shared<std::vector<wchar_t>>((size_t)maxNotes * maxNoteTextLength);
+
+	JobSystem::Defer([]() {
+		for (NoteSlot& slot : noteSlots)
+		{
+			GetOrCreateNoteActor(slot);
+		}
+	});
+}
+
+void NotePool::Place(XMVECTOR position, XMVECTOR rotation, const std::wstring& text)
+{
+	PROFILE_FUNCTION();
+
+	if (noteSlots.empty())
+	{
+		Log("Note not placed, note pool isn't initialised.");
+		return;
+	}
+
+	const int slotIndex = nextNoteSlot;
+	nextNoteSlot = (nextNoteSlot + 1) % (int)noteSlots.size();
+
+	NoteSlot& slot = noteSlots[slotIndex];
+
+	//Pool is full, the oldest note makes way.
+	if (placedNoteCount == (int)noteSlots.size())
+	{
+		HideNoteSlot(slotIndex);
+		RemoveFromNoteCell(slotIndex);
+	}
+	else
+	{
+		placedNoteCount++;
+	}
+
+	XMStoreFloat3(&slot.position, position);
+	XMStoreFloat4(&slot.rotation, rotation);
+	slot.cellKey = HashNoteCell(PositionToNoteCell(slot.position));
+	noteCells[slot.cellKey].push_back(slotIndex);
+
+	//A save still being written holds the old arena, it keeps that copy and the pool moves on to its own.
+	if (noteTextArena.use_count() > 1)
+	{
+		noteTextArena = std::make_shared<std::vector<wchar_t>>(*noteTextArena);
+	}
+
+	slot.textLength = std::min((int)text.size(), maxNoteTextLength);
+	wchar_t* slotText = &(*noteTextArena)[(size_t)slotIndex * maxNoteTextLength];
+	std::copy_n(text.data(), slot.textLength, slotText);
+
+	NoteActor* noteActor = GetOrCreateNoteActor(slot);
+	noteActor->SetPosition(position);
+	noteActor->SetRotation(rotation);
+	noteActor->SetNoteText(slotText, slot.textLength);
+
+	noteCellsDirty = true;
+}
+
+void NotePool::Clear()
+{
+	for (int slotIndex : nearbyNoteSlots)
+	{
+		HideNoteSlot(slotIndex);
+	}
+
+	nearbyNoteSlots.clear();
+	noteCells.clear();
+	nextNoteSlot = 0;
+	placedNoteCount = 0;
+	lastViewerNoteCell = UINT64_MAX;
+}
+
+void NotePool::Update(XMVECTOR viewerPosition)
+{
+	PROFILE_FUNCTION();
+
+	XMFLOAT3 viewerPos;
+	XMStoreFloat3(&viewerPos, viewerPosition);
+	const NoteCell viewerCell = PositionToNoteCell(viewerPos);
+	const uint64_t viewerKey = HashNoteCell(viewerCell);
+
+	if (viewerKey == lastViewerNoteCell && !noteCellsDirty) return;
+	lastViewerNoteCell = viewerKey;
+	noteCellsDirty = false;
+
+	noteNearbyStamp++;
+	std::swap(previousNearbyNoteSlots, nearbyNoteSlots);
+	nearbyNoteSlots.clear();
+
+	for (int z = viewerCell.z - noteShowRadiusCells; z <= viewerCell.z + noteShowRadiusCells; z++)
+	{
+		for (int y = viewerCell.y - noteShowRadiusCells; y <= viewerCell.y + noteShowRadiusCells; y++)
+		{
+			for (int x = viewerCell.x - noteShowRadiusCells; x <= viewerCell.x + noteShowRadiusCells; x++)
+			{
+				auto cellIt = noteCells.find(HashNoteCell({ x, y, z }));
+				if (cellIt == noteCells.end()) continue;
+
+				for (int slotIndex : cellIt->second)
+				{
+					NoteSlot& slot = noteSlots[slotIndex];
+					if (slot.actor == nullptr) continue;
+
+					slot.nearbyStamp = noteNearbyStamp;
+					nearbyNoteSlots.push_back(slotIndex);
+
+					if (!slot.nearby)
+					{
+						slot.actor->AddNoteWidgetToViewport();
+						slot.nearby = true;
+					}
+				}
+			}
+		}
+	}
+
+	for (int slotIndex : previousNearbyNoteSlots)
+	{
+		if (noteSlots[slotIndex].nearbyStamp != noteNearbyStamp)
+		{
+			HideNoteSlot(slotIndex);
+		}
+	}
+
+	PROFILE_COUNTER("Notes Nearby", (int64_t)nearbyNoteSlots.size());
+}
+
+int NotePool::GetNoteCount()
+{
+	return placedNoteCount;
+}
+
+int NotePool::GetMaxNotes()
+{
+	return (int)noteSlots.size();
+}
+
+NotePool::NoteSnapshot NotePool::Snapshot()
+{
+	NoteSnapshot snapshot;
+	snapshot.textArena = noteTextArena;
+	snapshot.notes.reserve(placedNoteCount);
+
+	//Until the pool fills up the oldest note is in slot 0, after that it's the next one to be reused.
+	const int firstSlot = placedNoteCount == (int)noteSlots.size() ? nextNoteSlot : 0;
+	for (int i = 0; i < placedNoteCount; i++)
+	{
+		const int slotIndex = (firstSlot + i) % (int)noteSlots.size();
+		const NoteSlot& slot = noteSlots[slotIndex];
+
+		PlacedNote note;
+		note.position = slot.position;
+		note.rotation = slot.rotation;
+		note.textOffset = (uint32_t)slotIndex * maxNoteTextLength;
+		note.textLength = (uint32_t)slot.textLength;
+		snapshot.notes.push_back(note);
+	}
+
+	return snapshot;
+}
+
+void NotePool::NotifyDestroyed(NoteActor* noteActor)
+{
+	for (NoteSlot& slot : noteSlots)
+	{
+		if (slot.actor == noteActor)
+		{
+			//Its widget has already gone with it, see ~NoteActor.
+			slot.actor = nullptr;
+			slot.nearby = false;
+			return;
+		}
+	}
+}
+
+void NotePool::Reset()
+{
+	noteSlots.clear();
+	noteTextArena.reset();
+	noteCells.clear();
+	nearbyNoteSlots.clear();
+	previousNearbyNoteSlots.clear();
+	nextNoteSlot = 0;
+	placedNoteCount = 0;
+	lastViewerNoteCell = UINT64_MAX;
+	noteCellsDirty = false;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+class NoteActor;
+
+//The Player's placed notes. A fixed number of NoteActors is allocated up front and reused, oldest
+//first, once they're all placed. Note text lives in one shared arena and notes are kept in a
+//spatial hash so only the ones near the viewer have their widgets handed to WorldWidgets.
+namespace NotePool
+{
+	//Longer text is cut off when placed.
+	const int maxNoteTextLength = 128;
+
+	struct PlacedNote
+	{
+		XMFLOAT3 position;
+		XMFLOAT4 rotation;
+		uint32_t textOffset;
+		uint32_t textLength;
+	};
+
+	//Every placed note, for saves. Shares the pool's text arena rather than copying the text, the
+	//pool copies the arena before its next write if a snapshot still holds it.
+	struct NoteSnapshot
+	{
+		std::shared_ptr<const std::vector<wchar_t>> textArena;
+		//Oldest first.
+		std::vector<PlacedNote> notes;
+
+		std::wstring_view GetText(const PlacedNote& note) const
+		{
+			return std::wstring_view(textArena->data() + note.textOffset, note.textLength);
+		}
+	};
+
+	//Sizes the pool and arena. The NoteActors themselves are added at the next deferred sync point.
+	void Init(int maxNotes);
+
+	void Place(XMVECTOR position, XMVECTOR rotation, const std::wstring& text);
+
+	//Hides every note. The pool stays allocated.
+	void Clear();
+
+	//Shows notes in the hash cells around the viewer and hides the ones left behind. Only does any
+	//work when the viewer changes cell or notes were placed.
+	void Update(XMVECTOR viewerPosition);
+
+	int GetNoteCount();
+	int GetMaxNotes();
+	NoteSnapshot Snapshot();
+
+	//Called from ~NoteActor. The slot keeps its note but stays hidden until it's placed into again,
+	//which adds a fresh actor for it.
+	void NotifyDestroyed(NoteActor* noteActor);
+
+	//Forgets the pool without touching its actors. Call before the world is unloaded.
+	void Reset();
+}
@@ -0,0 +1,370 @@
+#include "vpch.h"
+#include "OccupancyGrid.h"
+#include <cmath>
+#include <climits>
+#include <algorithm>
+#include <vector>
+#include "Components/MeshComponent.h"
+#include "Physics/Raycast.h"
+#include "BoundsUtils.h"
+#include "Actors/Game/Door.h"
+#include "Actors/Game/Enemy.h"
+#include "Actors/Game/Player.h"
+#include "DebugCommands.h"
+#include "Profiler.h"
+
+//Bigger than any level we ship. Stops a stray far-off mesh from allocating gigabytes.
+const int maxCellCount = 512 * 512 * 512;
+
+//Flat geometry (floor planes, thin walls) is snapped to the cell below its centre.
+const float cellEpsilon = 0.01f;
+
+const XMINT3 faceNeighbours[6] =
+{
+	{ 1, 0, 0 }, { -1, 0, 0 },
+	{ 0, 1, 0 }, { 0, -1, 0 },
+	{ 0, 0, 1 }, { 0, 0, -1 },
+};
+
+XMINT3 gridOrigin = { 0, 0, 0 };
+XMINT3 gridSize = { 0, 0, 0 };
+std::vector<uint8_t> gridCells;
+uint32_t gridVersion = 0;
+
+struct CellRange
+{
+	XMINT3 min;
+	XMINT3 max;
+};
+
+//The cells a mesh covers. range comes from the world AABB, and only the cells in it that touch the
+//mesh's oriented box are filled, so rotated meshes don't fill the empty corners of their AABB.
+struct MeshCells
+{
+	BoundingOrientedBox obb;
+	CellRange range;
+	uint8_t flags;
+};
+
+static int ToIndex(XMINT3 cell)
+{
+	const int x = cell.x - gridOrigin.x;
+	const int y = cell.y - gridOrigin.y;
+	const int z = cell.z - gridOrigin.z;
+
+	if (x < 0 || y < 0 || z < 0 || x >= gridSize.x || y >= gridSize.y || z >= gridSize.z)
+	{
+		return -1;
+	}
+
+	return x + (y * gridSize.x) + (z * gridSize.x * gridSize.y);
+}
+
+static void GetAxisCellRange(float center, float extent, int& outMin, int& outMax)
+{
+	outMin = (int)std::ceil(center - extent - 0.5f + cellEpsilon);
+	outMax = (int)std::floor(center + extent + 0.5f - cellEpsilon);
+
+	if (outMin > outMax)
+	{
+		outMin = outMax = (int)std::floor(center + 0.5f - cellEpsilon);
+	}
+}
+
+static CellRange GetCellRange(const BoundingBox& bounds)
+{
+	CellRange range;
+	GetAxisCellRange(bounds.Center.x, bounds.Extents.x, range.min.x, range.max.x);
+	GetAxisCellRange(bounds.Center.y, bounds.Extents.y, range.min.y, range.max.y);
+	GetAxisCellRange(bounds.Center.z, bounds.Extents.z, range.min.z, range.max.z);
+	return range;
+}
+
+template <typename Func>
+static void ForEachCell(const CellRange& range, Func func)
+{
+	for (int z = range.min.z; z <= range.max.z; z++)
+	{
+		for (int y = range.min.y; y <= range.max.y; y++)
+		{
+			for (int x = range.min.x; x <= range.max.x; x++)
+			{
+				func(XMINT3(x, y, z));
+			}
+		}
+	}
+}
+
+static MeshCells GetMeshCells(MeshComponent* mesh, uint8_t flags)
+{
+	MeshCells cells;
+	cells.obb = BoundsUtils::GetWorldOBB(mesh);
+	cells.range = GetCellRange(BoundsUtils::GetEnclosingAABB(cells.obb));
+	cells.flags = flags;
+	return cells;
+}
+
+//Every cell in range already overlaps the AABB, so for unrotated meshes this keeps all of them.
+template <typename Func>
+static void ForEachMeshCell(const MeshCells& mesh, Func func)
+{
+	ForEachCell(mesh.range, [&](XMINT3 cell) {
+		const BoundingBox cellBox(XMFLOAT3((float)cell.x, (float)cell.y, (float)cell.z), XMFLOAT3(0.5f, 0.5f, 0.5f));
+		if (mesh.obb.Intersects(cellBox))
+		{
+			func(cell);
+		}
+	});
+}
+
+static void UpdateFloorFlag(XMINT3 cell)
+{
+	const int index = ToIndex(cell);
+	if (index < 0) return;
+
+	gridCells[index] &= ~OccupancyGrid::Floor;
+
+	if (gridCells[index] & OccupancyGrid::Solid) return;
+
+	for (const XMINT3& offset : faceNeighbours)
+	{
+		if (OccupancyGrid::IsSolid(XMINT3(cell.x + offset.x, cell.y + offset.y, cell.z + offset.z)))
+		{
+			gridCells[index] |= OccupancyGrid::Floor;
+			return;
+		}
+	}
+}
+
+void OccupancyGrid::Build()
+{
+	PROFILE_FUNCTION();
+
+	Clear();
+	gridVersion++;
+
+	std::vector<MeshCells> meshCells;
+
+	XMINT3 min = { INT_MAX, INT_MAX, INT_MAX };
+	XMINT3 max = { INT_MIN, INT_MIN, INT_MIN };
+
+	for (MeshComponent* mesh : MeshComponent::system.GetComponents())
+	{
+		Actor* owner = mesh->GetOwner();
+
+		//Enemies move around, only static geometry goes into the grid.
+		if (dynamic_cast<Enemy*>(owner)) continue;
+
+		uint8_t flags = 0;
+		if (dynamic_cast<::Door*>(owner))
+		{
+			flags = OccupancyGrid::Door;
+			if (mesh->active)
+			{
+				flags |= Solid;
+			}
+		}
+		else if (mesh->active)
+		{
+			flags = Solid;
+		}
+		else
+		{
+			continue;
+		}
+
+		meshCells.push_back(GetMeshCells(mesh, flags));
+		const CellRange& range = meshCells.back().range;
+
+		min.x = std::min(min.x, range.min.x);
+		min.y = std::min(min.y, range.min.y);
+		min.z = std::min(min.z, range.min.z);
+		max.x = std::max(max.x, range.max.x);
+		max.y = std::max(max.y, range.max.y);
+		max.z = std::max(max.z, range.max.z);
+	}
+
+	if (meshCells.empty())
+	{
+		Log("Occupancy grid has no static meshes to build from.");
+		return;
+	}
+
+	//Pad by a cell on each side so the empty gridCells around the level's outer surfaces exist.
+	gridOrigin = XMINT3(min.x - 1, min.y - 1, min.z - 1);
+	gridSize = XMINT3(max.x - min.x + 3, max.y - min.y + 3, max.z - min.z + 3);
+
+	const int64_t cellCount = (int64_t)gridSize.x * gridSize.y * gridSize.z;
+	if (cellCount > maxCellCount)
+	{
+		Log("Occupancy grid of %lld gridCells is too large to build.", cellCount);
+		gridSize = XMINT3(0, 0, 0);
+		return;
+	}
+
+	gridCells.assign((size_t)cellCount, 0);
+
+	for (const MeshCells& mesh : meshCells)
+	{
+		ForEachMeshCell(mesh, [&](XMINT3 cell) { gridCells[ToIndex(cell)] |= mesh.flags; });
+	}
+
+	for (int z = 0; z < gridSize.z; z++)
+	{
+		for (int y = 0; y < gridSize.y; y++)
+		{
+			for (int x = 0; x < gridSize.x; x++)
+			{
+				UpdateFloorFlag(XMINT3(gridOrigin.x + x, gridOrigin.y + y, gridOrigin.z + z));
+			}
+		}
+	}
+
+	Log("Occupancy grid built with [%d, %d, %d] gridCells.", gridSize.x, gridSize.y, gridSize.z);
+}
+
+void OccupancyGrid::Clear()
+{
+	gridCells.clear();
+	gridOrigin = XMINT3(0, 0, 0);
+	gridSize = XMINT3(0, 0, 0);
+}
+
+bool OccupancyGrid::IsBuilt()
+{
+	return !gridCells.empty();
+}
+
+XMINT3 OccupancyGrid::PositionToCell(XMVECTOR position)
+{
+	XMFLOAT3 pos;
+	XMStoreFloat3(&pos, position);
+	return XMINT3((int)std::lround(pos.x), (int)std::lround(pos.y), (int)std::lround(pos.z));
+}
+
+XMVECTOR OccupancyGrid::CellToPosition(XMINT3 cell)
+{
+	return XMVectorSet((float)cell.x, (float)cell.y, (float)cell.z, 1.f);
+}
+
+int OccupancyGrid::GetCellCount()
+{
+	return (int)gridCells.size();
+}
+
+int OccupancyGrid::CellToIndex(XMINT3 cell)
+{
+	return ToIndex(cell);
+}
+
+XMINT3 OccupancyGrid::IndexToCell(int index)
+{
+	const int x = index % gridSize.x;
+	const int y = (index / gridSize.x) % gridSize.y;
+	const int z = index / (gridSize.x * gridSize.y);
+	return XMINT3(gridOrigin.x + x, gridOrigin.y + y, gridOrigin.z + z);
+}
+
+uint32_t OccupancyGrid::GetVersion()
+{
+	return gridVersion;
+}
+
+uint8_t OccupancyGrid::GetCellFlags(XMINT3 cell)
+{
+	const int index = ToIndex(cell);
+	if (index < 0) return 0;
+	return gridCells[index];
+}
+
+bool OccupancyGrid::IsSolid(XMINT3 cell)
+{
+	return GetCellFlags(cell) & Solid;
+}
+
+bool OccupancyGrid::IsSolid(XMVECTOR position)
+{
+	return IsSolid(PositionToCell(position));
+}
+
+static void SetDoorCellsSolid(MeshComponent* doorMesh, bool solid)
+{
+	if (!OccupancyGrid::IsBuilt()) return;
+
+	gridVersion++;
+
+	const MeshCells doorCells = GetMeshCells(doorMesh, OccupancyGrid::Door);
+	const CellRange& range = doorCells.range;
+
+	ForEachMeshCell(doorCells, [solid](XMINT3 cell) {
+		const int index = ToIndex(cell);
+		if (index >= 0 && (gridCells[index] & OccupancyGrid::Door))
+		{
+			if (solid)
+			{
+				gridCells[index] |= OccupancyGrid::Solid;
+			}
+			else
+			{
+				gridCells[index] &= ~OccupancyGrid::Solid;
+			}
+		}
+	});
+
+	//Floor flags around the door's old gridCells may have changed too.
+	const CellRange neighbourRange = { XMINT3(range.min.x - 1, range.min.y - 1, range.min.z - 1),
+		XMINT3(range.max.x + 1, range.max.y + 1, range.max.z + 1) };
+	ForEachCell(neighbourRange, [](XMINT3 cell) { UpdateFloorFlag(cell); });
+}
+
+void OccupancyGrid::OpenDoor(MeshComponent* doorMesh)
+{
+	SetDoorCellsSolid(doorMesh, false);
+}
+
+void OccupancyGrid::CloseDoor(MeshComponent* doorMesh)
+{
+	SetDoorCellsSolid(doorMesh, true);
+}
+
+int OccupancyGrid::ValidateAgainstRaycasts(Actor* actorToIgnore)
+{
+	int mismatchCount = 0;
+
+	for (int z = 0; z < gridSize.z; z++)
+	{
+		for (int y = 0; y < gridSize.y; y++)
+		{
+			for (int x = 0; x < gridSize.x; x++)
+			{
+				const XMINT3 cell(gridOrigin.x + x, gridOrigin.y + y, gridOrigin.z + z);
+				if (!(GetCellFlags(cell) & Floor)) continue;
+
+				for (const XMINT3& offset : faceNeighbours)
+				{
+					const XMINT3 neighbour(cell.x + offset.x, cell.y + offset.y, cell.z + offset.z);
+
+					Ray ray(actorToIgnore);
+					const bool rayHit = Raycast(ray, CellToPosition(cell), CellToPosition(neighbour));
+
+					//Enemies are left out of the grid on purpose.
+					if (rayHit && dynamic_cast<Enemy*>(ray.hitActor)) continue;
+
+					if (rayHit != IsSolid(neighbour))
+					{
+						Log("Occupancy grid mismatch from [%d, %d, %d] to [%d, %d, %d]. Raycast hit: %d",
+							cell.x, cell.y, cell.z, neighbour.x, neighbour.y, neighbour.z, rayHit);
+						mismatchCount++;
+					}
+				}
+			}
+		}
+	}
+
+	return mismatchCount;
+}
+
+static DebugCommands::Registration validateGridCommand("ValidateOccupancyGrid", []() {
+	if (!OccupancyGrid::IsBuilt()) return true;
+	return OccupancyGrid::ValidateAgainstRaycasts(Player::system.GetFirstActor()) == 0;
+});
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+class Actor;
+struct MeshComponent;
+
+//Packed 3D grid of the level's static geometry in movementIncrement sized cells.
+//Built once on level load so Player movement checks are cell lookups instead of raycasts.
+namespace OccupancyGrid
+{
+	enum CellFlags : uint8_t
+	{
+		//Cell is blocked by static geometry or a closed door.
+		Solid = 1 << 0,
+		//Empty cell with solid geometry on at least one face. Walls and ceilings count
+		//as the Player can walk on them.
+		Floor = 1 << 1,
+		//Cell is covered by a Door's mesh. Solid is cleared on it when the door opens.
+		Door = 1 << 2,
+	};
+
+	void Build();
+	void Clear();
+	bool IsBuilt();
+
+	XMINT3 PositionToCell(XMVECTOR position);
+	XMVECTOR CellToPosition(XMINT3 cell);
+
+	//Dense cell indices for systems keeping their own per-cell data. -1 for cells outside the grid.
+	int GetCellCount();
+	int CellToIndex(XMINT3 cell);
+	XMINT3 IndexToCell(int index);
+
+	//Bumped whenever the grid changes (built, door opened or closed), so cached searches know to throw out
+	//their results.
+	uint32_t GetVersion();
+
+	//Cells outside the grid are treated as empty space.
+	uint8_t GetCellFlags(XMINT3 cell);
+	bool IsSolid(XMINT3 cell);
+	bool IsSolid(XMVECTOR position);
+
+	void OpenDoor(MeshComponent* doorMesh);
+	void CloseDoor(MeshComponent* doorMesh);
+
+	//Debug check that fires a raycast between every floor cell and its neighbours and logs
+	//where the grid disagrees. Returns the number of mismatches. Runs on level load in debug
+	//builds and as the ValidateOccupancyGrid debug command.
+	int ValidateAgainstRaycasts(Actor* actorToIgnore);
+}
@@ -0,0 +1,299 @@
+#include "vpch.h"
+#include "OverworldStreaming.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "World.h"
+#include "TriggerBroadphase.h"
+#include "Profiler.h"
+#include "Actors/Game/LevelEntranceTrigger.h"
+#include "Components/MeshComponent.h"
+
+const float overworldChunkSize = 128.f;
+
+//Chunks within this many chunks of the ship (or its lookahead point) are streamed in. Streaming
+//out waits for one more chunk of distance so flying along a boundary doesn't thrash.
+const int chunkLoadRadius = 1;
+
+//How far ahead along its heading the ship's future position is predicted, in seconds of travel.
+const float chunkLookaheadSeconds = 4.f;
+
+//Spreads the work of large jumps over a few frames. Chunks nearest the ship go first.
+const int maxChunkTransitionsPerFrame = 4;
+
+//Once the ship is this many chunks from the origin, the world is shifted back under it.
+const int originShiftChunks = 4;
+
+struct ChunkMesh
+{
+	MeshComponent* mesh = nullptr;
+	//The mesh's own active state from before its chunk streamed out, so meshes that were already
+	//hidden (opened doors and the like) stay that way when it streams back in.
+	bool activeBeforeStreamOut = true;
+};
+
+struct OverworldChunk
+{
+	std::vector<ChunkMesh> meshes;
+	std::vector<Actor*> actors;
+	std::vector<LevelEntranceTrigger*> levelEntrances;
+	bool loaded = true;
+};
+
+std::unordered_map<uint64_t, OverworldChunk> overworldChunks;
+std::vector<uint64_t> loadedChunkKeys;
+
+std::unordered_set<const Actor*> streamedOutActors;
+
+XMINT2 overworldOriginChunk = { 0, 0 };
+XMINT2 overworldShipChunk = { 0, 0 };
+bool overworldBuilt = false;
+
+static uint64_t ChunkKey(XMINT2 chunk)
+{
+	return ((uint64_t)(uint32_t)chunk.x << 32) | (uint32_t)chunk.y;
+}
+
+static XMINT2 ChunkFromKey(uint64_t key)
+{
+	return XMINT2((int32_t)(uint32_t)(key >> 32), (int32_t)(uint32_t)key);
+}
+
+static XMINT2 PositionToChunk(XMVECTOR position)
+{
+	XMFLOAT3 pos;
+	XMStoreFloat3(&pos, position);
+	return XMINT2((int)std::floor(pos.x / overworldChunkSize) + overworldOriginChunk.x,
+		(int)std::floor(pos.z / overworldChunkSize) + overworldOriginChunk.y);
+}
+
+static int ChunkDistance(XMINT2 a, XMINT2 b)
+{
+	return std::max(std::abs(a.x - b.x), std::abs(a.y - b.y));
+}
+
+static void SetChunkLoaded(OverworldChunk& chunk, bool loaded)
+{
+	chunk.loaded = loaded;
+
+	for (ChunkMesh& chunkMesh : chunk.meshes)
+	{
+		if (loaded)
+		{
+			chunkMesh.mesh->active = chunkMesh.activeBeforeStreamOut;
+		}
+		else
+		{
+			chunkMesh.activeBeforeStreamOut = chunkMesh.mesh->active;
+			chunkMesh.mesh->active = false;
+		}
+	}
+
+	for (Actor* actor : chunk.actors)
+	{
+		if (loaded)
+		{
+			streamedOutActors.erase(actor);
+		}
+		else
+		{
+			streamedOutActors.insert(actor);
+		}
+	}
+
+	for (LevelEntranceTrigger* levelEntrance : chunk.levelEntrances)
+	{
+		levelEntrance->SetStreamedIn(loaded);
+	}
+}
+
+//Returns false once the frame's budget is spent.
+static bool LoadChunk(XMINT2 chunk, int& transitionsLeft)
+{
+	const uint64_t key = ChunkKey(chunk);
+	auto chunkIt = overworldChunks.find(key);
+	if (chunkIt == overworldChunks.end() || chunkIt->second.loaded) return true;
+
+	if (transitionsLeft <= 0) return false;
+	transitionsLeft--;
+
+	SetChunkLoaded(chunkIt->second, true);
+	loadedChunkKeys.push_back(key);
+	return true;
+}
+
+//Loads up to the frame's budget of chunks around center, a ring at a time outwards so a budget
+//spent partway through has loaded the nearest chunks rather than one side of the square.
+static bool LoadChunksAround(XMINT2 center, int& transitionsLeft)
+{
+	if (!LoadChunk(center, transitionsLeft)) return false;
+
+	for (int ring = 1; ring <= chunkLoadRadius; ring++)
+	{
+		//The top and bottom rows take the corners, the sides fill in between them.
+		for (int x = center.x - ring; x <= center.x + ring; x++)
+		{
+			if (!LoadChunk(XMINT2(x, center.y - ring), transitionsLeft)) return false;
+			if (!LoadChunk(XMINT2(x, center.y + ring), transitionsLeft)) return false;
+		}
+		for (int z = center.y - ring + 1; z <= center.y + ring - 1; z++)
+		{
+			if (!LoadChunk(XMINT2(center.x - ring, z), transitionsLeft)) return false;
+			if (!LoadChunk(XMINT2(center.x + ring, z), transitionsLeft)) return false;
+		}
+	}
+
+	return true;
+}
+
+static XMVECTOR ShiftOrigin(XMINT2 newOriginChunk)
+{
+	PROFILE_FUNCTION();
+
+	const XMVECTOR offset = XMVectorSet((float)(newOriginChunk.x - overworldOriginChunk.x) * overworldChunkSize,
+		0.f, (float)(newOriginChunk.y - overworldOriginChunk.y) * overworldChunkSize, 0.f);
+
+	for (Actor* actor : World::GetAllActorsInWorld())
+	{
+		actor->SetPosition(actor->GetPositionV() - offset);
+	}
+
+	overworldOriginChunk = newOriginChunk;
+
+	TriggerBroadphase::ShiftOrigin(offset);
+
+	return offset;
+}
+
+void OverworldStreaming::Build(Actor* ship)
+{
+	PROFILE_FUNCTION();
+
+	Reset();
+
+	for (MeshComponent* mesh : MeshComponent::system.GetComponents())
+	{
+		Actor* owner = mesh->GetOwner();
+		if (owner == ship) continue;
+
+		ChunkMesh chunkMesh;
+		chunkMesh.mesh = mesh;
+		overworldChunks[ChunkKey(PositionToChunk(owner->GetPositionV()))].meshes.push_back(chunkMesh);
+	}
+
+	for (Actor* actor : World::GetAllActorsInWorld())
+	{
+		if (actor == ship) continue;
+
+		overworldChunks[ChunkKey(PositionToChunk(actor->GetPositionV()))].actors.push_back(actor);
+	}
+
+	for (LevelEntranceTrigger* levelEntrance : LevelEntranceTrigger::system.GetActors())
+	{
+		overworldChunks[ChunkKey(PositionToChunk(levelEntrance->GetPositionV()))].levelEntrances.push_back(levelEntrance);
+	}
+
+	overworldShipChunk = PositionToChunk(ship->GetPositionV());
+	overworldBuilt = true;
+
+	//Everything starts out resident as the whole overworld was just loaded, drop the far chunks
+	//in one go rather than over the following frames.
+	for (auto& chunkPair : overworldChunks)
+	{
+		if (ChunkDistance(ChunkFromKey(chunkPair.first), overworldShipChunk) <= chunkLoadRadius)
+		{
+			loadedChunkKeys.push_back(chunkPair.first);
+		}
+		else
+		{
+			SetChunkLoaded(chunkPair.second, false);
+		}
+	}
+
+	Log("Overworld split into %d chunks, %d streamed in.", (int)overworldChunks.size(), (int)loadedChunkKeys.size());
+}
+
+XMVECTOR OverworldStreaming::Update(Actor* ship, float moveSpeed)
+{
+	PROFILE_FUNCTION();
+
+	if (!overworldBuilt) return XMVectorZero();
+
+	const XMVECTOR shipPosition = ship->GetPositionV();
+	overworldShipChunk = PositionToChunk(shipPosition);
+
+	XMVECTOR heading = ship->GetForwardVectorV();
+	heading = XMVector3Normalize(XMVectorSetY(heading, 0.f));
+	const XMINT2 lookaheadChunk = PositionToChunk(shipPosition + heading * moveSpeed * chunkLookaheadSeconds);
+
+	int transitionsLeft = maxChunkTransitionsPerFrame;
+
+	if (LoadChunksAround(overworldShipChunk, transitionsLeft))
+	{
+		LoadChunksAround(lookaheadChunk, transitionsLeft);
+	}
+
+	for (size_t i = 0; i < loadedChunkKeys.size() && transitionsLeft > 0;)
+	{
+		const XMINT2 chunk = ChunkFromKey(loadedChunkKeys[i]);
+		const bool keep = ChunkDistance(chunk, overworldShipChunk) <= chunkLoadRadius + 1 ||
+			ChunkDistance(chunk, lookaheadChunk) <= chunkLoadRadius;
+
+		if (keep)
+		{
+			i++;
+			continue;
+		}
+
+		SetChunkLoaded(overworldChunks[loadedChunkKeys[i]], false);
+		transitionsLeft--;
+
+		loadedChunkKeys[i] = loadedChunkKeys.back();
+		loadedChunkKeys.pop_back();
+	}
+
+	if (ChunkDistance(overworldShipChunk, overworldOriginChunk) > originShiftChunks)
+	{
+		return ShiftOrigin(overworldShipChunk);
+	}
+
+	return XMVectorZero();
+}
+
+bool OverworldStreaming::IsBuilt()
+{
+	return overworldBuilt;
+}
+
+XMINT2 OverworldStreaming::GetShipChunk()
+{
+	return overworldShipChunk;
+}
+
+XMINT2 OverworldStreaming::GetOriginChunk()
+{
+	return overworldOriginChunk;
+}
+
+bool OverworldStreaming::IsStreamedOut(const Actor* actor)
+{
+	return streamedOutActors.find(actor) != streamedOutActors.end();
+}
+
+int OverworldStreaming::GetLoadedChunkCount()
+{
+	return (int)loadedChunkKeys.size();
+}
+
+void OverworldStreaming::Reset()
+{
+	overworldChunks.clear();
+	loadedChunkKeys.clear();
+	streamedOutActors.clear();
+	overworldOriginChunk = { 0, 0 };
+	overworldShipChunk = { 0, 0 };
+	overworldBuilt = false;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+class Actor;
+
+//Splits the overworld into square XZ chunks and only keeps the ones around the PlayerShip (and
+//where its heading and speed will take it) streamed in. Streamed out chunks have their meshes
+//deactivated, their level entrances pulled from the trigger broadphase and their actors' Ticks
+//skipped.
+//The world is also kept near the origin by shifting everything back a whole number of chunks
+//when the ship strays too far, so float precision holds up however far it travels.
+namespace OverworldStreaming
+{
+	//Sorts the overworld's meshes and level entrances into chunks. Called from PlayerShip::Start.
+	void Build(Actor* ship);
+
+	//Called once a frame after the ship has moved. Returns how far the world was shifted back to
+	//recentre the origin this frame, zero most frames.
+	XMVECTOR Update(Actor* ship, float moveSpeed);
+
+	bool IsBuilt();
+
+	//Absolute chunk coordinates, unaffected by origin shifts.
+	XMINT2 GetShipChunk();
+	XMINT2 GetOriginChunk();
+	int GetLoadedChunkCount();
+
+	//Whether actor's chunk is streamed out. Checked first thing in game actors' Tick so actors far
+	//from the ship stop updating.
+	bool IsStreamedOut(const Actor* actor);
+
+	void Reset();
+}
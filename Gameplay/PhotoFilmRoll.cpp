@@ -0,0 +1,41 @@
+#include "vpch.h"
+#include "PhotoFilmRoll.h"
+#include <algorithm>
+
+void PhotoFilmRoll::Load(int exposureCount)
+{
+	//Comes from an editor property, a negative count would wrap around in reserve().
+	if (exposureCount < 0)
+	{
+		Log("Film roll exposure count %d is negative, loading an empty roll.", exposureCount);
+		exposureCount = 0;
+	}
+
+	photoFilenames.clear();
+	photoFilenames.reserve(exposureCount);
+
+	for (int i = 0; i < exposureCount; i++)
+	{
+		photoFilenames.push_back(L"photo" + std::to_wstring(i) + L".jpg");
+	}
+
+	exposuresTaken = 0;
+}
+
+const std::wstring& PhotoFilmRoll::TakeExposure()
+{
+	const std::wstring& filename = photoFilenames.at(exposuresTaken);
+	exposuresTaken++;
+
+	if (!HasFilmLeft() && onRollFinished)
+	{
+		onRollFinished();
+	}
+
+	return filename;
+}
+
+void PhotoFilmRoll::SetExposuresTaken(int count)
+{
+	exposuresTaken = std::max(0, std::min(count, GetExposureCount()));
+}
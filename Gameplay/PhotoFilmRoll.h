@@ -0,0 +1,32 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+//The Player's camera film. Hands out a filename per exposure until the roll runs out.
+//Only the filenames live here, the capture itself is Renderer::PlayerPhotoCapture's.
+class PhotoFilmRoll
+{
+public:
+	//Negative counts load an empty roll.
+	void Load(int exposureCount);
+
+	bool HasFilmLeft() const { return exposuresTaken < (int)photoFilenames.size(); }
+	int GetExposuresTaken() const { return exposuresTaken; }
+	int GetExposureCount() const { return (int)photoFilenames.size(); }
+
+	//Returns the filename the next photo should be written to and advances the roll.
+	//Only call when HasFilmLeft().
+	const std::wstring& TakeExposure();
+
+	//For restoring saves. Clamped to the roll's length and doesn't fire onRollFinished.
+	void SetExposuresTaken(int count);
+
+	//Fires once the last exposure on the roll is taken.
+	std::function<void()> onRollFinished;
+
+private:
+	std::vector<std::wstring> photoFilenames;
+	int exposuresTaken = 0;
+};
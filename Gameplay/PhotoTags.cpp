@@ -0,0 +1,83 @@
+#include "vpch.h"
+#include "PhotoTags.h"
+#include <unordered_map>
+#include <vector>
+#include "Gameplay/GameInstance.h"
+
+std::unordered_map<std::string, PhotoTagID> photoTagIDs;
+std::shared_ptr<std::vector<std::string>> photoTagNames = std::make_shared<std::vector<std::string>>();
+
+PhotoTagSet capturedPhotoTags;
+uint32_t capturedVersion = 0;
+
+PhotoTagID PhotoTags::Intern(const std::string& tag)
+{
+	auto tagIt = photoTagIDs.find(tag);
+	if (tagIt != photoTagIDs.end())
+	{
+		return tagIt->second;
+	}
+
+	if (photoTagNames->size() >= MAX_PHOTO_TAGS)
+	{
+		Log("Photo tag [%s] not registered, over the %d tag limit.", tag.c_str(), MAX_PHOTO_TAGS);
+		return INVALID_PHOTO_TAG;
+	}
+
+	if (photoTagNames.use_count() > 1)
+	{
+		photoTagNames = std::make_shared<std::vector<std::string>>(*photoTagNames);
+	}
+
+	const PhotoTagID id = (PhotoTagID)photoTagNames->size();
+	photoTagNames->push_back(tag);
+	photoTagIDs.emplace(tag, id);
+	return id;
+}
+
+const std::string& PhotoTags::GetTagName(PhotoTagID id)
+{
+	return photoTagNames->at(id);
+}
+
+const PhotoTagSet& PhotoTags::GetCaptured()
+{
+	return capturedPhotoTags;
+}
+
+bool PhotoTags::MarkCaptured(const std::string& tag)
+{
+	const PhotoTagID id = Intern(tag);
+	if (id == INVALID_PHOTO_TAG) return false;
+
+	if (!capturedPhotoTags.test(id))
+	{
+		capturedPhotoTags.set(id);
+		GameInstance::playerPhotoTagsCaptured.insert(tag);
+		capturedVersion++;
+	}
+
+	return true;
+}
+
+void PhotoTags::SetCaptured(const std::vector<std::string>& tags)
+{
+	capturedPhotoTags.reset();
+	GameInstance::playerPhotoTagsCaptured.clear();
+	capturedVersion++;
+
+	for (const std::string& tag : tags)
+	{
+		MarkCaptured(tag);
+	}
+}
+
+std::shared_ptr<const std::vector<std::string>> PhotoTags::GetNameTable()
+{
+	return photoTagNames;
+}
+
+uint32_t PhotoTags::GetVersion()
+{
+	return capturedVersion;
+}
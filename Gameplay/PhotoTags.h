@@ -0,0 +1,39 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using PhotoTagID = uint16_t;
+
+static const int MAX_PHOTO_TAGS = 512;
+static const PhotoTagID INVALID_PHOTO_TAG = UINT16_MAX;
+
+using PhotoTagSet = std::bitset<MAX_PHOTO_TAGS>;
+
+//Interns salvage photo tags into dense IDs and keeps what the Player has captured as a bitset, so
+//captured and required tags are checked without string compares or allocations.
+namespace PhotoTags
+{
+	PhotoTagID Intern(const std::string& tag);
+	const std::string& GetTagName(PhotoTagID id);
+
+	//The one record of what the Player has photographed. Every write goes through here and is
+	//mirrored into GameInstance::playerPhotoTagsCaptured for engine code that reads that set.
+	const PhotoTagSet& GetCaptured();
+
+	//Returns false if the tag couldn't be interned.
+	bool MarkCaptured(const std::string& tag);
+
+	//Replaces the captured tags, for restoring saves.
+	void SetCaptured(const std::vector<std::string>& tags);
+
+	//Every interned tag's name, indexed by ID. Shared rather than copied so saves can hold it while
+	//they're written. Interning a new tag copies the table first if anything else still holds it.
+	std::shared_ptr<const std::vector<std::string>> GetNameTable();
+
+	//Bumped whenever the captured tags change, so readers can cache anything derived from them.
+	uint32_t GetVersion();
+}
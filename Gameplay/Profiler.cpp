@@ -0,0 +1,247 @@
+#include "vpch.h"
+#include "Profiler.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifndef GAME_SHIPPING
+
+const int maxProfileEventsPerThread = 1 << 16;
+const int maxProfileCounters = 32;
+
+struct ProfileEvent
+{
+	const char* name;
+	int64_t timestampNs;
+	int64_t value;
+	char phase;
+};
+
+struct ThreadProfileBuffer
+{
+	std::unique_ptr<ProfileEvent[]> events{ new ProfileEvent[maxProfileEventsPerThread] };
+	std::atomic<int> eventCount{ 0 };
+	int threadIndex = 0;
+};
+
+struct ProfileCounter
+{
+	std::atomic<const char*> name{ nullptr };
+	std::atomic<int64_t> value{ 0 };
+};
+
+//Only locked when a thread records its first event. Buffers live until shutdown as worker
+//threads live as long as the game.
+std::mutex profileBuffersMutex;
+std::vector<std::unique_ptr<ThreadProfileBuffer>> profileBuffers;
+thread_local ThreadProfileBuffer* threadProfileBuffer = nullptr;
+
+ProfileCounter profileCounters[maxProfileCounters];
+
+std::atomic<bool> profileCapturing{ false };
+std::chrono::steady_clock::time_point profileCaptureStart;
+std::string profileCaptureFilename;
+int profileCaptureFramesLeft = 0;
+
+static int64_t GetProfileTimestamp()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - profileCaptureStart).count();
+}
+
+static ThreadProfileBuffer& GetThreadProfileBuffer()
+{
+	if (threadProfileBuffer == nullptr)
+	{
+		std::lock_guard<std::mutex> lock(profileBuffersMutex);
+		profileBuffers.push_back(std::make_unique<ThreadProfileBuffer>());
+		threadProfileBuffer = profileBuffers.back().get();
+		threadProfileBuffer->threadIndex = (int)profileBuffers.size() - 1;
+	}
+
+	return *threadProfileBuffer;
+}
+
+static void RecordProfileEvent(const char* name, char phase, int64_t value)
+{
+	if (!profileCapturing.load(std::memory_order_relaxed)) return;
+
+	ThreadProfileBuffer& buffer = GetThreadProfileBuffer();
+	const int index = buffer.eventCount.load(std::memory_order_relaxed);
+
+	//A full buffer drops events rather than wrapping, so begin and end pairs stay matched up to
+	//the point it filled.
+	if (index >= maxProfileEventsPerThread) return;
+
+	ProfileEvent& event = buffer.events[index];
+	event.name = name;
+	event.timestampNs = GetProfileTimestamp();
+	event.value = value;
+	event.phase = phase;
+
+	buffer.eventCount.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::BeginZone(const char* name)
+{
+	RecordProfileEvent(name, 'B', 0);
+}
+
+void Profiler::EndZone()
+{
+	RecordProfileEvent(nullptr, 'E', 0);
+}
+
+void Profiler::AddToCounter(const char* name, int64_t value)
+{
+	if (!profileCapturing.load(std::memory_order_relaxed)) return;
+
+	for (ProfileCounter& counter : profileCounters)
+	{
+		const char* counterName = counter.name.load(std::memory_order_acquire);
+		if (counterName == nullptr)
+		{
+			//Claim the free slot. Another thread may have beaten us to it with a different counter.
+			if (!counter.name.compare_exchange_strong(counterName, name))
+			{
+				if (std::strcmp(counterName, name) != 0) continue;
+			}
+		}
+		else if (counterName != name && std::strcmp(counterName, name) != 0)
+		{
+			continue;
+		}
+
+		counter.value.fetch_add(value, std::memory_order_relaxed);
+		return;
+	}
+
+	Log("Out of profiler counter slots for [%s].", name);
+}
+
+void Profiler::BeginFrame()
+{
+	if (!IsCapturing()) return;
+
+	for (ProfileCounter& counter : profileCounters)
+	{
+		const char* name = counter.name.load(std::memory_order_acquire);
+		if (name == nullptr) break;
+
+		RecordProfileEvent(name, 'C', counter.value.exchange(0));
+	}
+
+	if (--profileCaptureFramesLeft <= 0)
+	{
+		StopCapture();
+	}
+}
+
+void Profiler::StartCapture(const std::string& filename, int frameCount)
+{
+	if (IsCapturing())
+	{
+		Log("Profiler capture to [%s] already running.", profileCaptureFilename.c_str());
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(profileBuffersMutex);
+		for (auto& buffer : profileBuffers)
+		{
+			buffer->eventCount = 0;
+		}
+	}
+
+	for (ProfileCounter& counter : profileCounters)
+	{
+		counter.value = 0;
+	}
+
+	profileCaptureFilename = filename;
+	profileCaptureFramesLeft = frameCount;
+	profileCaptureStart = std::chrono::steady_clock::now();
+	profileCapturing = true;
+}
+
+static void WriteJsonString(std::ofstream& file, const char* str)
+{
+	file << '"';
+	for (const char* c = str; *c; c++)
+	{
+		if (*c == '"' || *c == '\\') file << '\\';
+		file << *c;
+	}
+	file << '"';
+}
+
+bool Profiler::StopCapture()
+{
+	if (!IsCapturing()) return false;
+
+	profileCapturing = false;
+
+	std::ofstream file(profileCaptureFilename);
+	if (!file.is_open())
+	{
+		Log("Couldn't open [%s] to write profiler capture to.", profileCaptureFilename.c_str());
+		return false;
+	}
+
+	file << "{\"traceEvents\":[\n";
+
+	bool firstEvent = true;
+	int droppedBuffers = 0;
+
+	std::lock_guard<std::mutex> lock(profileBuffersMutex);
+	for (auto& buffer : profileBuffers)
+	{
+		const int eventCount = buffer->eventCount.load(std::memory_order_acquire);
+		if (eventCount >= maxProfileEventsPerThread) droppedBuffers++;
+
+		for (int i = 0; i < eventCount; i++)
+		{
+			const ProfileEvent& event = buffer->events[i];
+
+			if (!firstEvent) file << ",\n";
+			firstEvent = false;
+
+			file << "{\"ph\":\"" << event.phase << "\",\"ts\":" << (double)event.timestampNs / 1000.0
+				<< ",\"pid\":0,\"tid\":" << buffer->threadIndex;
+
+			if (event.name)
+			{
+				file << ",\"name\":";
+				WriteJsonString(file, event.name);
+			}
+
+			if (event.phase == 'C')
+			{
+				file << ",\"args\":{\"value\":" << event.value << "}";
+			}
+
+			file << "}";
+		}
+	}
+
+	file << "\n]}\n";
+
+	if (droppedBuffers > 0)
+	{
+		Log("%d threads filled their profiler buffers, capture is missing events.", droppedBuffers);
+	}
+
+	Log("Profiler capture written to [%s].", profileCaptureFilename.c_str());
+	return true;
+}
+
+bool Profiler::IsCapturing()
+{
+	return profileCapturing.load(std::memory_order_relaxed);
+}
+
+#endif
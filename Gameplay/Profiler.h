@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+//Scoped timing zones and per-frame counters for gameplay code, captured over a number of frames
+//and written out as Chrome trace_event JSON (open in chrome://tracing or Perfetto).
+//Define GAME_SHIPPING to compile every zone and counter out.
+#ifndef GAME_SHIPPING
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+//Name has to be a string literal or otherwise outlive the capture, it isn't copied.
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__FUNCTION__)
+#define PROFILE_COUNTER(name, value) Profiler::AddToCounter(name, value)
+#define PROFILE_FRAME() Profiler::BeginFrame()
+#define PROFILE_START_CAPTURE(filename, frameCount) Profiler::StartCapture(filename, frameCount)
+
+#else
+
+#define PROFILE_ZONE(name)
+#define PROFILE_FUNCTION()
+#define PROFILE_COUNTER(name, value)
+#define PROFILE_FRAME()
+#define PROFILE_START_CAPTURE(filename, frameCount)
+
+#endif
+
+namespace Profiler
+{
+	//Called at the top of the level driving actor's Tick. Writes last frame's counters to the
+	//capture, zeroes them and ends the capture once it has run for its frame count.
+	void BeginFrame();
+
+	//Each thread writes to its own event buffer, nothing is locked once a thread has recorded
+	//its first event.
+	void BeginZone(const char* name);
+	void EndZone();
+
+	//Counters are summed over a frame. Safe to call from job threads.
+	void AddToCounter(const char* name, int64_t value);
+
+	//Start and stop from the game thread only, outside of any parallel work.
+	void StartCapture(const std::string& filename, int frameCount);
+	bool StopCapture();
+	bool IsCapturing();
+}
+
+struct ProfileZone
+{
+	ProfileZone(const char* name) { Profiler::BeginZone(name); }
+	~ProfileZone() { Profiler::EndZone(); }
+};
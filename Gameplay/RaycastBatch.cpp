@@ -0,0 +1,298 @@
+#include "vpch.h"
+#include "RaycastBatch.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include "BoundsUtils.h"
+#include "ActorRef.h"
+#include "OccupancyGrid.h"
+#include "DebugCommands.h"
+#include "Components/MeshComponent.h"
+#include "Profiler.h"
+
+const int boxesPerLane = 4;
+
+//Stand-in for zero direction components so the slab test's reciprocal stays finite. A zero
+//component would give 0 * inf = NaN for rays starting on a box's face.
+const float minRayDirection = 1e-8f;
+
+//Shared by every batch until the next InvalidateSceneBoxes(), and reused so rebuilding doesn't
+//allocate once warmed up.
+//World AABBs as structure-of-arrays, padded to a multiple of boxesPerLane with inverted boxes
+//that can never be hit.
+std::vector<float> raycastBoxMinX, raycastBoxMinY, raycastBoxMinZ;
+std::vector<float> raycastBoxMaxX, raycastBoxMaxY, raycastBoxMaxZ;
+//The exact boxes the AABBs were built from, tested only once a ray is inside an AABB.
+std::vector<BoundingOrientedBox> raycastBoxOBBs;
+std::vector<Actor*> raycastBoxOwners;
+
+bool raycastBoxesBuilt = false;
+//Destroyed actors would leave dangling owners behind, and doors toggle their mesh's active state.
+uint32_t raycastBoxesDestroyGeneration = 0;
+uint32_t raycastBoxesGridVersion = 0;
+
+template <typename Func>
+static void ForEachRaycastBoxArray(Func func)
+{
+	func(raycastBoxMinX); func(raycastBoxMinY); func(raycastBoxMinZ);
+	func(raycastBoxMaxX); func(raycastBoxMaxY); func(raycastBoxMaxZ);
+}
+
+static bool SceneBoxesAreCurrent()
+{
+	return raycastBoxesBuilt &&
+		raycastBoxesDestroyGeneration == ActorRefs::GetGeneration() &&
+		raycastBoxesGridVersion == OccupancyGrid::GetVersion();
+}
+
+static void BuildSceneBoxes()
+{
+	PROFILE_FUNCTION();
+
+	ForEachRaycastBoxArray([](std::vector<float>& values) { values.clear(); });
+	raycastBoxOBBs.clear();
+	raycastBoxOwners.clear();
+
+	for (MeshComponent* mesh : MeshComponent::system.GetComponents())
+	{
+		if (!mesh->active) continue;
+
+		const BoundingOrientedBox obb = BoundsUtils::GetWorldOBB(mesh);
+		const BoundingBox aabb = BoundsUtils::GetEnclosingAABB(obb);
+
+		raycastBoxMinX.push_back(aabb.Center.x - aabb.Extents.x);
+		raycastBoxMinY.push_back(aabb.Center.y - aabb.Extents.y);
+		raycastBoxMinZ.push_back(aabb.Center.z - aabb.Extents.z);
+		raycastBoxMaxX.push_back(aabb.Center.x + aabb.Extents.x);
+		raycastBoxMaxY.push_back(aabb.Center.y + aabb.Extents.y);
+		raycastBoxMaxZ.push_back(aabb.Center.z + aabb.Extents.z);
+		raycastBoxOBBs.push_back(obb);
+		raycastBoxOwners.push_back(mesh->GetOwner());
+	}
+
+	while (raycastBoxMinX.size() % boxesPerLane != 0)
+	{
+		raycastBoxMinX.push_back(1.f); raycastBoxMinY.push_back(1.f); raycastBoxMinZ.push_back(1.f);
+		raycastBoxMaxX.push_back(-1.f); raycastBoxMaxY.push_back(-1.f); raycastBoxMaxZ.push_back(-1.f);
+	}
+
+	raycastBoxesBuilt = true;
+	raycastBoxesDestroyGeneration = ActorRefs::GetGeneration();
+	raycastBoxesGridVersion = OccupancyGrid::GetVersion();
+}
+
+void RaycastBatch::InvalidateSceneBoxes()
+{
+	raycastBoxesBuilt = false;
+}
+
+static float SafeReciprocal(float direction)
+{
+	if (std::abs(direction) < minRayDirection)
+	{
+		direction = direction < 0.f ? -minRayDirection : minRayDirection;
+	}
+	return 1.f / direction;
+}
+
+int RaycastBatch::Add(XMVECTOR origin, XMVECTOR end, Actor* actorToIgnore)
+{
+	const XMVECTOR direction = end - origin;
+	const float length = XMVectorGetX(XMVector3Length(direction));
+
+	BatchRay ray;
+	XMStoreFloat3(&ray.origin, origin);
+	XMStoreFloat3(&ray.direction, XMVector3Normalize(direction));
+	ray.length = length;
+	ray.actorToIgnore = actorToIgnore;
+	rays.push_back(ray);
+
+	executed = false;
+
+	return (int)rays.size() - 1;
+}
+
+void RaycastBatch::Execute()
+{
+	PROFILE_FUNCTION();
+	PROFILE_COUNTER("Raycasts", (int64_t)rays.size());
+
+	hits.assign(rays.size(), RaycastBatchHit());
+	executed = true;
+
+	if (rays.empty()) return;
+
+	if (!SceneBoxesAreCurrent())
+	{
+		BuildSceneBoxes();
+	}
+
+	const int boxCount = (int)raycastBoxOwners.size();
+
+	const XMVECTOR zero = XMVectorZero();
+
+	//Boxes rather than rays go in the lanes, as most batches are a single ray.
+	for (size_t rayIndex = 0; rayIndex < rays.size(); rayIndex++)
+	{
+		const BatchRay& ray = rays[rayIndex];
+		RaycastBatchHit& hit = hits[rayIndex];
+
+		//Zero length rays have no direction to test along.
+		if (ray.length <= 0.f) continue;
+
+		const XMVECTOR ox = XMVectorReplicate(ray.origin.x);
+		const XMVECTOR oy = XMVectorReplicate(ray.origin.y);
+		const XMVECTOR oz = XMVectorReplicate(ray.origin.z);
+		const XMVECTOR idx = XMVectorReplicate(SafeReciprocal(ray.direction.x));
+		const XMVECTOR idy = XMVectorReplicate(SafeReciprocal(ray.direction.y));
+		const XMVECTOR idz = XMVectorReplicate(SafeReciprocal(ray.direction.z));
+
+		const XMVECTOR rayOrigin = XMLoadFloat3(&ray.origin);
+		const XMVECTOR rayDirection = XMLoadFloat3(&ray.direction);
+
+		//Closest exact hit so far, starts as the ray's length.
+		float nearest = ray.length;
+
+		for (int first = 0; first < boxCount; first += boxesPerLane)
+		{
+			const XMVECTOR t1x = (XMLoadFloat4((const XMFLOAT4*)&raycastBoxMinX[first]) - ox) * idx;
+			const XMVECTOR t2x = (XMLoadFloat4((const XMFLOAT4*)&raycastBoxMaxX[first]) - ox) * idx;
+			const XMVECTOR t1y = (XMLoadFloat4((const XMFLOAT4*)&raycastBoxMinY[first]) - oy) * idy;
+			const XMVECTOR t2y = (XMLoadFloat4((const XMFLOAT4*)&raycastBoxMaxY[first]) - oy) * idy;
+			const XMVECTOR t1z = (XMLoadFloat4((const XMFLOAT4*)&raycastBoxMinZ[first]) - oz) * idz;
+			const XMVECTOR t2z = (XMLoadFloat4((const XMFLOAT4*)&raycastBoxMaxZ[first]) - oz) * idz;
+
+			const XMVECTOR tNear = XMVectorMax(XMVectorMax(XMVectorMin(t1x, t2x), XMVectorMin(t1y, t2y)),
+				XMVectorMax(XMVectorMin(t1z, t2z), zero));
+			const XMVECTOR tFar = XMVectorMin(XMVectorMin(XMVectorMax(t1x, t2x), XMVectorMax(t1y, t2y)),
+				XMVectorMax(t1z, t2z));
+
+			//An AABB's entry distance is never further than its OBB's, so boxes entered past the
+			//nearest exact hit can't beat it.
+			const XMVECTOR hitMask = XMVectorAndInt(XMVectorLessOrEqual(tNear, tFar),
+				XMVectorLessOrEqual(tNear, XMVectorReplicate(nearest)));
+
+			//Nothing to do for any of these boxes. The common case, keeps the loop branch cheap.
+			if (XMVector4EqualInt(hitMask, XMVectorFalseInt())) continue;
+
+			XMUINT4 hitLanes;
+			XMStoreUInt4(&hitLanes, hitMask);
+			const uint32_t* hitLane = &hitLanes.x;
+
+			const int laneCount = std::min(boxesPerLane, boxCount - first);
+			for (int lane = 0; lane < laneCount; lane++)
+			{
+				if (!hitLane[lane]) continue;
+
+				const int box = first + lane;
+				if (raycastBoxOwners[box] == ray.actorToIgnore) continue;
+
+				//Exact test against the oriented box, the AABB of a rotated box is mostly empty space.
+				float distance = 0.f;
+				if (!raycastBoxOBBs[box].Intersects(rayOrigin, rayDirection, distance)) continue;
+
+				//Rays starting inside a box hit it straight away.
+				distance = std::max(distance, 0.f);
+				if (distance > nearest) continue;
+
+				nearest = distance;
+				hit.hitActor = raycastBoxOwners[box];
+				hit.hitDistance = distance;
+			}
+		}
+	}
+}
+
+void RaycastBatch::Reset()
+{
+	rays.clear();
+	hits.clear();
+	executed = false;
+}
+
+bool RaycastBatch::GetHit(int rayIndex, RaycastBatchHit& hit) const
+{
+	if (!executed || rayIndex < 0 || rayIndex >= (int)hits.size())
+	{
+		return false;
+	}
+
+	hit = hits[rayIndex];
+	return hit.hitActor != nullptr;
+}
+
+//Checks the lane culling against testing every oriented box one by one, for rays between random
+//points inside the scene's bounds.
+static DebugCommands::Registration raycastBatchCommand("RaycastBatchMatchesBruteForce", []() {
+	RaycastBatch::InvalidateSceneBoxes();
+
+	std::vector<BoundingOrientedBox> boxes;
+	std::vector<Actor*> owners;
+	for (MeshComponent* mesh : MeshComponent::system.GetComponents())
+	{
+		if (!mesh->active) continue;
+		boxes.push_back(BoundsUtils::GetWorldOBB(mesh));
+		owners.push_back(mesh->GetOwner());
+	}
+
+	if (boxes.empty()) return true;
+
+	BoundingBox sceneBounds = BoundsUtils::GetEnclosingAABB(boxes[0]);
+	for (const BoundingOrientedBox& box : boxes)
+	{
+		BoundingBox::CreateMerged(sceneBounds, sceneBounds, BoundsUtils::GetEnclosingAABB(box));
+	}
+
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> unit(-1.f, 1.f);
+	auto randomPoint = [&]() {
+		return XMVectorSet(sceneBounds.Center.x + unit(random) * sceneBounds.Extents.x,
+			sceneBounds.Center.y + unit(random) * sceneBounds.Extents.y,
+			sceneBounds.Center.z + unit(random) * sceneBounds.Extents.z, 1.f);
+	};
+
+	const int rayCount = 512;
+	std::vector<XMVECTOR> origins, ends;
+	RaycastBatch batch;
+	for (int i = 0; i < rayCount; i++)
+	{
+		origins.push_back(randomPoint());
+		ends.push_back(randomPoint());
+		batch.Add(origins.back(), ends.back());
+	}
+	batch.Execute();
+
+	int mismatchCount = 0;
+	for (int i = 0; i < rayCount; i++)
+	{
+		const XMVECTOR direction = ends[i] - origins[i];
+		const float length = XMVectorGetX(XMVector3Length(direction));
+		if (length <= 0.f) continue;
+
+		Actor* expectedActor = nullptr;
+		float nearest = length;
+		for (size_t box = 0; box < boxes.size(); box++)
+		{
+			float distance = 0.f;
+			if (!boxes[box].Intersects(origins[i], XMVector3Normalize(direction), distance)) continue;
+			distance = std::max(distance, 0.f);
+			if (distance > nearest) continue;
+			nearest = distance;
+			expectedActor = owners[box];
+		}
+
+		RaycastBatchHit hit;
+		const bool batchHit = batch.GetHit(i, hit);
+		const bool expectedHit = expectedActor != nullptr;
+
+		//Boxes at the same distance can tie either way, only the distance has to agree then.
+		if (batchHit != expectedHit || (batchHit && std::abs(hit.hitDistance - nearest) > 0.001f))
+		{
+			Log("RaycastBatch ray %d hit %d at %f, brute force hit %d at %f.", i, batchHit, hit.hitDistance,
+				expectedHit, nearest);
+			mismatchCount++;
+		}
+	}
+
+	return mismatchCount == 0;
+});
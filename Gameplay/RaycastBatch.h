@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+class Actor;
+
+struct RaycastBatchHit
+{
+	Actor* hitActor = nullptr;
+	float hitDistance = 0.f;
+};
+
+//Collects rays for a frame and resolves all of them in a single pass over the scene.
+//Each ray is tested against four meshes' world AABBs at a time, with an exact test against the
+//mesh's oriented bounds only for the AABBs it passes through.
+//The scene's boxes are gathered once per frame and shared by every batch.
+class RaycastBatch
+{
+public:
+	//Called once per frame by the level driving actor, before any batch executes, so meshes that
+	//moved since last frame are picked up. Boxes are also rebuilt within a frame if an actor is
+	//destroyed or a door opens or closes.
+	static void InvalidateSceneBoxes();
+
+	//Returns the index to read the ray's hit back with after Execute().
+	int Add(XMVECTOR origin, XMVECTOR end, Actor* actorToIgnore = nullptr);
+	void Execute();
+	void Reset();
+
+	bool GetHit(int rayIndex, RaycastBatchHit& hit) const;
+	int GetRayCount() const { return (int)rays.size(); }
+	bool IsExecuted() const { return executed; }
+
+private:
+	struct BatchRay
+	{
+		XMFLOAT3 origin;
+		XMFLOAT3 direction;
+		float length;
+		Actor* actorToIgnore;
+	};
+
+	std::vector<BatchRay> rays;
+	std::vector<RaycastBatchHit> hits;
+
+	bool executed = false;
+};
@@ -0,0 +1,751 @@
+#include "vpch.h"
+#include "SaveSnapshot.h"
+#include <Windows.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <random>
+#include <unordered_set>
+#include <vector>
+#include "NotePool.h"
+#include "LevelLoader.h"
+#include "PhotoTags.h"
+#include "ActorRef.h"
+#include "JobSystem.h"
+#include "DebugCommands.h"
+#include "Profiler.h"
+#include "Actors/Game/Player.h"
+#include "Actors/Game/Door.h"
+
+using SnapshotClock = std::chrono::steady_clock;
+
+const uint32_t saveSnapshotMagic = 0x56415356; //"VSAV"
+//2 added the level name and closed doors being restored.
+const uint32_t saveSnapshotVersion = 2;
+
+//Far past any real save. Checked before the header's sizes are trusted with an allocation.
+const uint32_t maxSaveSnapshotBytes = 64 * 1024 * 1024;
+
+struct NoteSaveState
+{
+	XMFLOAT3 position;
+	XMFLOAT4 rotation;
+	std::wstring text;
+};
+
+//A save as read back from a file.
+struct SaveSnapshotData
+{
+	//Saves only hold progress, not the level itself, so they only load into the level they were made in.
+	std::string levelName;
+	PlayerSaveState player;
+	std::vector<std::string> capturedPhotoTags;
+	//Every door not listed is closed on restore.
+	std::vector<std::string> openDoors;
+	std::vector<NoteSaveState> notes;
+};
+
+//A save as captured from the world on the game thread. No strings are copied: photo tag names, door
+//names and note text are shared with the systems that own them, which copy their buffer before
+//changing it while a capture still holds it. Immutable once handed to the worker so the world can
+//carry on changing while it is written.
+struct CapturedSnapshot
+{
+	std::string levelName;
+	PlayerSaveState player;
+	PhotoTagSet capturedPhotoTags;
+	std::shared_ptr<const std::vector<std::string>> photoTagNames;
+	//One open flag per name.
+	std::shared_ptr<const std::vector<std::string>> doorNames;
+	std::vector<uint8_t> doorsOpen;
+	NotePool::NoteSnapshot notes;
+};
+
+//Door names don't change within a level, so every capture shares this table and only copies which
+//doors are open. Rebuilt when any actor is destroyed, and dropped by Reset() on level load.
+std::shared_ptr<const std::vector<std::string>> saveDoorNames;
+uint32_t saveDoorNamesGeneration = 0;
+
+std::future<SaveSnapshot::SnapshotTimings> saveWriteFuture;
+SaveSnapshot::SnapshotTimings lastSnapshotTimings;
+
+static double SnapshotElapsedMs(SnapshotClock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(SnapshotClock::now() - start).count();
+}
+
+//--- Packing ---
+
+class SnapshotWriter
+{
+public:
+	template <typename T>
+	void Write(const T& value)
+	{
+		const size_t offset = bytes.size();
+		bytes.resize(offset + sizeof(T));
+		std::memcpy(bytes.data() + offset, &value, sizeof(T));
+	}
+
+	void WriteString(const std::string& str)
+	{
+		Write((uint32_t)str.size());
+		bytes.insert(bytes.end(), str.begin(), str.end());
+	}
+
+	//Stored as UTF-16 code units, same as wchar_t on Windows.
+	void WriteWString(std::wstring_view str)
+	{
+		Write((uint32_t)str.size());
+		for (wchar_t c : str)
+		{
+			Write((uint16_t)c);
+		}
+	}
+
+	std::vector<uint8_t> bytes;
+};
+
+class SnapshotReader
+{
+public:
+	SnapshotReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+	template <typename T>
+	bool Read(T& value)
+	{
+		if (offset + sizeof(T) > size) return false;
+		std::memcpy(&value, data + offset, sizeof(T));
+		offset += sizeof(T);
+		return true;
+	}
+
+	bool ReadString(std::string& str)
+	{
+		uint32_t length = 0;
+		if (!Read(length) || offset + length > size) return false;
+		str.assign((const char*)data + offset, length);
+		offset += length;
+		return true;
+	}
+
+	bool ReadWString(std::wstring& str)
+	{
+		uint32_t length = 0;
+		if (!Read(length) || offset + (size_t)length * sizeof(uint16_t) > size) return false;
+
+		str.resize(length);
+		for (uint32_t i = 0; i < length; i++)
+		{
+			uint16_t c;
+			Read(c);
+			str[i] = (wchar_t)c;
+		}
+		return true;
+	}
+
+private:
+	const uint8_t* data;
+	size_t size;
+	size_t offset = 0;
+};
+
+//Written in the same layout UnpackSnapshot() reads into SaveSnapshotData.
+static void PackSnapshot(const CapturedSnapshot& data, SnapshotWriter& writer)
+{
+	writer.WriteString(data.levelName);
+	writer.Write(data.player.position);
+	writer.Write(data.player.rotation);
+	writer.Write((int32_t)data.player.combatActionPoints);
+	writer.Write((int32_t)data.player.filmExposuresTaken);
+
+	const std::vector<std::string>& tagNames = *data.photoTagNames;
+	writer.Write((uint32_t)data.capturedPhotoTags.count());
+	for (size_t id = 0; id < tagNames.size(); id++)
+	{
+		if (data.capturedPhotoTags.test(id))
+		{
+			writer.WriteString(tagNames[id]);
+		}
+	}
+
+	const std::vector<std::string>& doorNames = *data.doorNames;
+	writer.Write((uint32_t)std::count(data.doorsOpen.begin(), data.doorsOpen.end(), (uint8_t)1));
+	for (size_t i = 0; i < doorNames.size(); i++)
+	{
+		if (data.doorsOpen[i])
+		{
+			writer.WriteString(doorNames[i]);
+		}
+	}
+
+	writer.Write((uint32_t)data.notes.notes.size());
+	for (const NotePool::PlacedNote& note : data.notes.notes)
+	{
+		writer.Write(note.position);
+		writer.Write(note.rotation);
+		writer.WriteWString(data.notes.GetText(note));
+	}
+}
+
+static bool UnpackSnapshot(SnapshotReader& reader, SaveSnapshotData& data)
+{
+	int32_t combatActionPoints = 0, filmExposuresTaken = 0;
+	if (!reader.ReadString(data.levelName) || !reader.Read(data.player.position) || !reader.Read(data.player.rotation) ||
+		!reader.Read(combatActionPoints) || !reader.Read(filmExposuresTaken))
+	{
+		return false;
+	}
+	data.player.combatActionPoints = combatActionPoints;
+	data.player.filmExposuresTaken = filmExposuresTaken;
+
+	uint32_t count = 0;
+	if (!reader.Read(count)) return false;
+	data.capturedPhotoTags.resize(count);
+	for (std::string& tag : data.capturedPhotoTags)
+	{
+		if (!reader.ReadString(tag)) return false;
+	}
+
+	if (!reader.Read(count)) return false;
+	data.openDoors.resize(count);
+	for (std::string& doorName : data.openDoors)
+	{
+		if (!reader.ReadString(doorName)) return false;
+	}
+
+	if (!reader.Read(count)) return false;
+	data.notes.resize(count);
+	for (NoteSaveState& note : data.notes)
+	{
+		if (!reader.Read(note.position) || !reader.Read(note.rotation) || !reader.ReadWString(note.text))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//--- Compression ---
+//Byte oriented LZ77 in the style of LZ4 blocks. Each sequence is a token (literal count in the high
+//nibble, match length - 4 in the low), the literals, then a 16 bit match offset. Counts of 15
+//continue in following bytes. The last sequence is literals only. Saves are mostly repeated
+//names and small numbers so this gets most of the win of a real codec at memcpy like speeds.
+
+const int lzMinMatch = 4;
+const int lzHashBits = 14;
+const size_t lzMaxOffset = 0xFFFF;
+//A match can't grow by more than 255 bytes per compressed byte spent on its length.
+const size_t lzMaxExpansion = 255;
+
+static void WriteLZLength(std::vector<uint8_t>& out, size_t length)
+{
+	while (length >= 255)
+	{
+		out.push_back(255);
+		length -= 255;
+	}
+	out.push_back((uint8_t)length);
+}
+
+static bool ReadLZLength(const uint8_t* src, size_t srcSize, size_t& ip, size_t& length)
+{
+	uint8_t byte;
+	do
+	{
+		if (ip >= srcSize) return false;
+		byte = src[ip++];
+		length += byte;
+	} while (byte == 255);
+
+	return true;
+}
+
+static void WriteLZSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalCount,
+	size_t offset, size_t matchLength, bool lastSequence)
+{
+	const size_t matchCode = lastSequence ? 0 : matchLength - lzMinMatch;
+	out.push_back((uint8_t)((std::min<size_t>(literalCount, 15) << 4) | std::min<size_t>(matchCode, 15)));
+
+	if (literalCount >= 15) WriteLZLength(out, literalCount - 15);
+	out.insert(out.end(), literals, literals + literalCount);
+
+	if (lastSequence) return;
+
+	out.push_back((uint8_t)(offset & 0xFF));
+	out.push_back((uint8_t)(offset >> 8));
+	if (matchCode >= 15) WriteLZLength(out, matchCode - 15);
+}
+
+static uint32_t ReadLZ32(const uint8_t* src)
+{
+	uint32_t value;
+	std::memcpy(&value, src, sizeof(value));
+	return value;
+}
+
+static void CompressLZ(const std::vector<uint8_t>& src, std::vector<uint8_t>& out)
+{
+	out.clear();
+	out.reserve(src.size() / 2 + 16);
+
+	std::vector<int64_t> hashTable(1 << lzHashBits, -1);
+
+	size_t anchor = 0;
+	size_t i = 0;
+	while (i + lzMinMatch <= src.size())
+	{
+		const uint32_t sequence = ReadLZ32(&src[i]);
+		const uint32_t hash = (sequence * 2654435761u) >> (32 - lzHashBits);
+		const int64_t candidate = hashTable[hash];
+		hashTable[hash] = (int64_t)i;
+
+		if (candidate < 0 || i - candidate > lzMaxOffset || ReadLZ32(&src[candidate]) != sequence)
+		{
+			i++;
+			continue;
+		}
+
+		size_t matchLength = lzMinMatch;
+		while (i + matchLength < src.size() && src[candidate + matchLength] == src[i + matchLength])
+		{
+			matchLength++;
+		}
+
+		WriteLZSequence(out, &src[anchor], i - anchor, i - candidate, matchLength, false);
+		i += matchLength;
+		anchor = i;
+	}
+
+	WriteLZSequence(out, src.data() + anchor, src.size() - anchor, 0, 0, true);
+}
+
+//Out has to be sized to the uncompressed size up front. Fails on anything malformed rather than
+//reading or writing out of bounds, including a stream cut off before its literals only last sequence.
+static bool DecompressLZ(const uint8_t* src, size_t srcSize, std::vector<uint8_t>& out)
+{
+	size_t ip = 0;
+	size_t op = 0;
+
+	while (ip < srcSize)
+	{
+		const uint8_t token = src[ip++];
+
+		size_t literalCount = token >> 4;
+		if (literalCount == 15 && !ReadLZLength(src, srcSize, ip, literalCount)) return false;
+		if (ip + literalCount > srcSize || op + literalCount > out.size()) return false;
+
+		std::memcpy(out.data() + op, src + ip, literalCount);
+		ip += literalCount;
+		op += literalCount;
+
+		if (ip == srcSize) return op == out.size();
+
+		if (ip + 2 > srcSize) return false;
+		const size_t offset = src[ip] | (src[ip + 1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > op) return false;
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !ReadLZLength(src, srcSize, ip, matchLength)) return false;
+		matchLength += lzMinMatch;
+		if (op + matchLength > out.size()) return false;
+
+		//Byte at a time as matches can overlap the bytes they're writing.
+		for (size_t j = 0; j < matchLength; j++, op++)
+		{
+			out[op] = out[op - offset];
+		}
+	}
+
+	return false;
+}
+
+//--- File IO ---
+
+//Written beside the save and renamed over it once complete, so a failed or interrupted write leaves
+//the previous save intact rather than a truncated one.
+static SaveSnapshot::SnapshotTimings WriteSnapshot(std::shared_ptr<const CapturedSnapshot> data, std::string filename)
+{
+	const auto start = SnapshotClock::now();
+
+	SaveSnapshot::SnapshotTimings timings;
+
+	SnapshotWriter writer;
+	PackSnapshot(*data, writer);
+
+	std::vector<uint8_t> compressed;
+	CompressLZ(writer.bytes, compressed);
+
+	timings.uncompressedBytes = writer.bytes.size();
+	timings.compressedBytes = compressed.size();
+
+	const std::string tempFilename = filename + ".tmp";
+
+	std::ofstream file(tempFilename, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		Log("Couldn't open [%s] to write save to.", tempFilename.c_str());
+		return timings;
+	}
+
+	const uint32_t header[] = { saveSnapshotMagic, saveSnapshotVersion,
+		(uint32_t)writer.bytes.size(), (uint32_t)compressed.size() };
+	file.write((const char*)header, sizeof(header));
+	file.write((const char*)compressed.data(), compressed.size());
+	file.close();
+
+	if (file.fail())
+	{
+		Log("Writing save [%s] failed, previous save kept.", tempFilename.c_str());
+		DeleteFileA(tempFilename.c_str());
+		return timings;
+	}
+
+	if (!MoveFileExA(tempFilename.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+	{
+		Log("Couldn't replace save [%s], error %lu. Previous save kept.", filename.c_str(), GetLastError());
+		DeleteFileA(tempFilename.c_str());
+		return timings;
+	}
+
+	timings.written = true;
+	timings.writeMs = SnapshotElapsedMs(start);
+	return timings;
+}
+
+//Read only view of a whole file, unmapped when it goes out of scope.
+class MappedSaveFile
+{
+public:
+	~MappedSaveFile()
+	{
+		if (view) UnmapViewOfFile(view);
+		if (mapping) CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+	}
+
+	bool Open(const std::string& filename)
+	{
+		file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) return false;
+		size = (size_t)fileSize.QuadPart;
+
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping) return false;
+
+		view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		return view != nullptr;
+	}
+
+	const uint8_t* GetData() const { return (const uint8_t*)view; }
+	size_t GetSize() const { return size; }
+
+private:
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+	void* view = nullptr;
+	size_t size = 0;
+};
+
+static void CollectFinishedSave()
+{
+	if (!saveWriteFuture.valid()) return;
+	if (saveWriteFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+
+	const SaveSnapshot::SnapshotTimings timings = saveWriteFuture.get();
+	lastSnapshotTimings.writeMs = timings.writeMs;
+	lastSnapshotTimings.uncompressedBytes = timings.uncompressedBytes;
+	lastSnapshotTimings.compressedBytes = timings.compressedBytes;
+	lastSnapshotTimings.written = timings.written;
+}
+
+//--- Capture and restore ---
+
+static void CaptureSnapshot(Player* player, CapturedSnapshot& data)
+{
+	data.levelName = LevelLoader::GetCurrentLevelName();
+	player->WriteSaveState(data.player);
+
+	data.capturedPhotoTags = PhotoTags::GetCaptured();
+	data.photoTagNames = PhotoTags::GetNameTable();
+
+	const auto& doors = Door::system.GetActors();
+	if (!saveDoorNames || saveDoorNamesGeneration != ActorRefs::GetGeneration() || saveDoorNames->size() != doors.size())
+	{
+		auto doorNames = std::make_shared<std::vector<std::string>>();
+		doorNames->reserve(doors.size());
+		for (Door* door : doors)
+		{
+			doorNames->push_back(door->GetName());
+		}
+		saveDoorNames = std::move(doorNames);
+		saveDoorNamesGeneration = ActorRefs::GetGeneration();
+	}
+
+	data.doorNames = saveDoorNames;
+	data.doorsOpen.reserve(doors.size());
+	for (Door* door : doors)
+	{
+		data.doorsOpen.push_back(door->IsOpen() ? 1 : 0);
+	}
+
+	//Oldest first so the restored pool reuses notes in the same order.
+	data.notes = NotePool::Snapshot();
+}
+
+static void RestoreSnapshot(Player* player, SaveSnapshotData& data)
+{
+	player->ReadSaveState(data.player);
+
+	PhotoTags::SetCaptured(data.capturedPhotoTags);
+
+	//Doors opened since the save have to be closed again, not just the saved ones opened.
+	std::unordered_set<std::string> openDoorNames(data.openDoors.begin(), data.openDoors.end());
+	for (Door* door : Door::system.GetActors())
+	{
+		const bool open = openDoorNames.erase(door->GetName()) > 0;
+		if (open && !door->IsOpen())
+		{
+			door->Open();
+		}
+		else if (!open && door->IsOpen())
+		{
+			door->Close();
+		}
+	}
+
+	for (const std::string& doorName : openDoorNames)
+	{
+		Log("Saved open door [%s] not found in level.", doorName.c_str());
+	}
+
+	//Deferred like Player::SpawnNote() as placing can add the pool's NoteActors.
+	auto notes = std::make_shared<const std::vector<NoteSaveState>>(std::move(data.notes));
+	JobSystem::Defer([notes]() {
+		NotePool::Clear();
+		for (const NoteSaveState& note : *notes)
+		{
+			NotePool::Place(XMLoadFloat3(&note.position), XMLoadFloat4(&note.rotation), note.text);
+		}
+	});
+}
+
+bool SaveSnapshot::Save(Player* player, const std::string& filename)
+{
+	PROFILE_FUNCTION();
+
+	if (IsSaving())
+	{
+		Log("Save to [%s] skipped, previous save still writing.", filename.c_str());
+		return false;
+	}
+
+	const auto start = SnapshotClock::now();
+
+	auto data = std::make_shared<CapturedSnapshot>();
+	CaptureSnapshot(player, *data);
+
+	lastSnapshotTimings.captureMs = SnapshotElapsedMs(start);
+
+	saveWriteFuture = std::async(std::launch::async, WriteSnapshot,
+		std::shared_ptr<const CapturedSnapshot>(std::move(data)), filename);
+
+	return true;
+}
+
+bool SaveSnapshot::Load(Player* player, const std::string& filename)
+{
+	PROFILE_FUNCTION();
+
+	//Could be the file being loaded.
+	WaitForSave();
+
+	const auto start = SnapshotClock::now();
+
+	MappedSaveFile file;
+	if (!file.Open(filename))
+	{
+		Log("Couldn't map save file [%s].", filename.c_str());
+		return false;
+	}
+
+	SnapshotReader headerReader(file.GetData(), file.GetSize());
+	uint32_t magic = 0, version = 0, uncompressedSize = 0, compressedSize = 0;
+	headerReader.Read(magic);
+	headerReader.Read(version);
+	headerReader.Read(uncompressedSize);
+	headerReader.Read(compressedSize);
+
+	const size_t headerSize = sizeof(uint32_t) * 4;
+	if (magic != saveSnapshotMagic || version != saveSnapshotVersion ||
+		file.GetSize() < headerSize + compressedSize)
+	{
+		Log("[%s] isn't a version %u save.", filename.c_str(), saveSnapshotVersion);
+		return false;
+	}
+
+	//The header's sizes aren't trusted until they fit the file that was actually read.
+	if (uncompressedSize > maxSaveSnapshotBytes || uncompressedSize > (size_t)compressedSize * lzMaxExpansion)
+	{
+		Log("Save file [%s] is corrupt.", filename.c_str());
+		return false;
+	}
+
+	std::vector<uint8_t> payload(uncompressedSize);
+	if (!DecompressLZ(file.GetData() + headerSize, compressedSize, payload))
+	{
+		Log("Save file [%s] is corrupt.", filename.c_str());
+		return false;
+	}
+
+	SaveSnapshotData data;
+	SnapshotReader reader(payload.data(), payload.size());
+	if (!UnpackSnapshot(reader, data))
+	{
+		Log("Save file [%s] is truncated.", filename.c_str());
+		return false;
+	}
+
+	if (data.levelName != LevelLoader::GetCurrentLevelName())
+	{
+		Log("Save file [%s] is for level [%s], not the current level.", filename.c_str(), data.levelName.c_str());
+		return false;
+	}
+
+	RestoreSnapshot(player, data);
+
+	lastSnapshotTimings.restoreMs = SnapshotElapsedMs(start);
+	return true;
+}
+
+bool SaveSnapshot::IsSaving()
+{
+	CollectFinishedSave();
+	return saveWriteFuture.valid();
+}
+
+void SaveSnapshot::WaitForSave()
+{
+	if (saveWriteFuture.valid())
+	{
+		saveWriteFuture.wait();
+		CollectFinishedSave();
+	}
+}
+
+SaveSnapshot::SnapshotTimings SaveSnapshot::GetLastTimings()
+{
+	CollectFinishedSave();
+	return lastSnapshotTimings;
+}
+
+void SaveSnapshot::Reset()
+{
+	saveDoorNames.reset();
+	saveDoorNamesGeneration = 0;
+}
+
+//Compresses buffers shaped to hit each part of the LZ format (no matches, long literal and match
+//runs, overlapping matches) and packs a synthetic capture, checking everything reads back the same.
+static DebugCommands::Registration saveSnapshotCommand("SaveSnapshotRoundTrip", []() {
+	std::mt19937 random(1234);
+	std::vector<std::vector<uint8_t>> buffers;
+	buffers.emplace_back();
+	buffers.emplace_back(3, (uint8_t)7);
+	buffers.emplace_back(4096, (uint8_t)0);
+
+	std::vector<uint8_t> noise(5000);
+	for (uint8_t& byte : noise) byte = (uint8_t)random();
+	buffers.push_back(noise);
+
+	const std::string text = "Door_Hangar_01 Door_Hangar_02 PhotoTag_Wreck PhotoTag_Beacon ";
+	std::vector<uint8_t> repeatedText;
+	for (int i = 0; i < 200; i++)
+	{
+		repeatedText.insert(repeatedText.end(), text.begin(), text.end());
+		repeatedText.push_back((uint8_t)random());
+	}
+	buffers.push_back(repeatedText);
+
+	//A 600 byte literal run into a 1000 byte match at offset 1, both past the 15 + 255 length bytes.
+	std::vector<uint8_t> runs(noise.begin(), noise.begin() + 600);
+	runs.insert(runs.end(), 1000, (uint8_t)0xAB);
+	buffers.push_back(runs);
+
+	int failureCount = 0;
+	for (const std::vector<uint8_t>& buffer : buffers)
+	{
+		std::vector<uint8_t> compressed;
+		CompressLZ(buffer, compressed);
+
+		std::vector<uint8_t> decompressed(buffer.size());
+		if (!DecompressLZ(compressed.data(), compressed.size(), decompressed) || decompressed != buffer)
+		{
+			Log("LZ round trip of %zu bytes failed.", buffer.size());
+			failureCount++;
+			continue;
+		}
+
+		//A stream cut short has to be refused, not read past.
+		std::vector<uint8_t> truncated(buffer.size());
+		if (DecompressLZ(compressed.data(), compressed.size() - 1, truncated))
+		{
+			Log("LZ stream of %zu bytes decompressed despite being truncated.", buffer.size());
+			failureCount++;
+		}
+	}
+
+	CapturedSnapshot captured;
+	captured.levelName = "SaveRoundTrip.vmap";
+	captured.player.position = XMFLOAT3(1.f, 2.f, 3.f);
+	captured.player.combatActionPoints = 4;
+	captured.player.filmExposuresTaken = 5;
+	captured.photoTagNames = std::make_shared<const std::vector<std::string>>(
+		std::vector<std::string>{ "Wreck", "Beacon", "Hull" });
+	captured.capturedPhotoTags.set(0);
+	captured.capturedPhotoTags.set(2);
+	captured.doorNames = std::make_shared<const std::vector<std::string>>(
+		std::vector<std::string>{ "DoorA", "DoorB", "DoorC" });
+	captured.doorsOpen = { 0, 1, 1 };
+
+	const std::wstring noteText = L"First noteSecond";
+	captured.notes.textArena = std::make_shared<const std::vector<wchar_t>>(noteText.begin(), noteText.end());
+	captured.notes.notes.push_back({ XMFLOAT3(0.f, 1.f, 0.f), XMFLOAT4(0.f, 0.f, 0.f, 1.f), 0, 10 });
+	captured.notes.notes.push_back({ XMFLOAT3(5.f, 1.f, 0.f), XMFLOAT4(0.f, 0.f, 0.f, 1.f), 10, 6 });
+
+	SnapshotWriter writer;
+	PackSnapshot(captured, writer);
+
+	SaveSnapshotData unpacked;
+	SnapshotReader reader(writer.bytes.data(), writer.bytes.size());
+	const bool unpackedAll = UnpackSnapshot(reader, unpacked);
+	if (!unpackedAll || unpacked.levelName != captured.levelName ||
+		unpacked.player.position.z != 3.f || unpacked.player.filmExposuresTaken != 5 ||
+		unpacked.capturedPhotoTags != std::vector<std::string>{ "Wreck", "Hull" } ||
+		unpacked.openDoors != std::vector<std::string>{ "DoorB", "DoorC" } ||
+		unpacked.notes.size() != 2 || unpacked.notes[0].text != L"First note" ||
+		unpacked.notes[1].text != L"Second" || unpacked.notes[1].position.x != 5.f)
+	{
+		Log("Packed save snapshot didn't unpack to what was captured.");
+		failureCount++;
+	}
+
+	SnapshotReader truncatedReader(writer.bytes.data(), writer.bytes.size() - 1);
+	SaveSnapshotData truncatedData;
+	if (UnpackSnapshot(truncatedReader, truncatedData))
+	{
+		Log("Truncated save snapshot unpacked without an error.");
+		failureCount++;
+	}
+
+	return failureCount == 0;
+});
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+class Player;
+
+struct PlayerSaveState
+{
+	XMFLOAT3 position = {};
+	XMFLOAT4 rotation = { 0.f, 0.f, 0.f, 1.f };
+	int combatActionPoints = 0;
+	int filmExposuresTaken = 0;
+};
+
+//Versioned binary saves of the current level's progress: the Player, captured photo tags, open
+//doors and placed notes. Save() only copies state on the game thread, packing, compressing and
+//writing the file happen on a worker. Strings are shared with their owning systems rather than
+//copied, and the file is written beside the save then renamed over it. Load() maps the file instead of reading it, and refuses saves
+//made in a different level.
+namespace SaveSnapshot
+{
+	struct SnapshotTimings
+	{
+		//Game thread time spent copying state out of the world.
+		double captureMs = 0.0;
+		//Worker time spent packing, compressing and writing.
+		double writeMs = 0.0;
+		//Game thread time spent mapping, decompressing and applying a save.
+		double restoreMs = 0.0;
+		size_t uncompressedBytes = 0;
+		size_t compressedBytes = 0;
+		//False if the write failed and the previous save was kept.
+		bool written = false;
+	};
+
+	//Returns false without saving if the previous save is still being written.
+	bool Save(Player* player, const std::string& filename);
+	bool Load(Player* player, const std::string& filename);
+
+	bool IsSaving();
+	//Blocks until the save in flight (if any) is on disk.
+	void WaitForSave();
+
+	SnapshotTimings GetLastTimings();
+
+	//Drops the cached door name table. Called on level load.
+	void Reset();
+}
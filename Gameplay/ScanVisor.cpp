@@ -0,0 +1,105 @@
+#include "vpch.h"
+#include "ScanVisor.h"
+#include <algorithm>
+#include <cmath>
+#include "ActorRef.h"
+#include "OccupancyGrid.h"
+#include "Profiler.h"
+
+const int scanConeRingRays = 8;
+
+//Small enough to ignore float noise from an idle camera's transform.
+const float scanRequeryEpsilon = 0.0001f;
+
+static bool ActorIsScannable(Actor* actor)
+{
+	return actor && !actor->scanText.empty();
+}
+
+bool ScanVisor::NeedsRequery(XMVECTOR origin, XMVECTOR forward)
+{
+	if (!hasResult) return true;
+
+	const XMVECTOR epsilon = XMVectorReplicate(scanRequeryEpsilon);
+	if (!XMVector3NearEqual(origin, XMLoadFloat3(&lastOrigin), epsilon)) return true;
+	if (!XMVector3NearEqual(forward, XMLoadFloat3(&lastForward), epsilon)) return true;
+
+	//Doors and enemies going away can reveal what was behind them.
+	if (ActorRefs::GetGeneration() != lastDestroyGeneration) return true;
+
+	//Doors opening can too.
+	if (OccupancyGrid::GetVersion() != lastGridVersion) return true;
+
+	//Anything else moving or being destroyed is only caught by the periodic recast, as checking the
+	//cached actors themselves would mean touching actors that may no longer exist.
+	return ++framesSinceCast >= maxFramesBetweenCasts;
+}
+
+bool ScanVisor::Update(XMVECTOR origin, XMVECTOR forward, Actor* actorToIgnore)
+{
+	if (!NeedsRequery(origin, forward))
+	{
+		PROFILE_COUNTER("Scan Requeries Skipped", 1);
+		return false;
+	}
+
+	PROFILE_FUNCTION();
+
+	XMStoreFloat3(&lastOrigin, origin);
+	XMStoreFloat3(&lastForward, forward);
+	lastDestroyGeneration = ActorRefs::GetGeneration();
+	lastGridVersion = OccupancyGrid::GetVersion();
+	framesSinceCast = 0;
+	hasResult = true;
+
+	forward = XMVector3Normalize(forward);
+
+	//Any axis not parallel to forward works for building the ring.
+	XMVECTOR side = XMVector3Cross(forward, XMVectorSet(0.f, 1.f, 0.f, 0.f));
+	if (XMVectorGetX(XMVector3LengthSq(side)) < 0.001f)
+	{
+		side = XMVector3Cross(forward, XMVectorSet(1.f, 0.f, 0.f, 0.f));
+	}
+	side = XMVector3Normalize(side);
+	const XMVECTOR up = XMVector3Cross(side, forward);
+
+	const float ringRadius = std::tan(XMConvertToRadians(coneAngle));
+
+	coneBatch.Reset();
+	coneBatch.Add(origin, origin + forward * range, actorToIgnore);
+	for (int i = 0; i < scanConeRingRays; i++)
+	{
+		float sin, cos;
+		XMScalarSinCos(&sin, &cos, XM_2PI * (float)i / (float)scanConeRingRays);
+		const XMVECTOR direction = XMVector3Normalize(forward + (side * cos + up * sin) * ringRadius);
+		coneBatch.Add(origin, origin + direction * range, actorToIgnore);
+	}
+	coneBatch.Execute();
+
+	RaycastBatchHit hit;
+	target = coneBatch.GetHit(0, hit) ? hit.hitActor : nullptr;
+
+	highlighted.clear();
+	highlightedPositions.clear();
+	for (int i = 1; i < coneBatch.GetRayCount(); i++)
+	{
+		if (!coneBatch.GetHit(i, hit) || hit.hitActor == target || !ActorIsScannable(hit.hitActor)) continue;
+		if (std::find(highlighted.begin(), highlighted.end(), hit.hitActor) != highlighted.end()) continue;
+
+		highlighted.push_back(hit.hitActor);
+
+		XMFLOAT3 position;
+		XMStoreFloat3(&position, hit.hitActor->GetPositionV());
+		highlightedPositions.push_back(position);
+	}
+
+	return true;
+}
+
+void ScanVisor::Reset()
+{
+	target = nullptr;
+	highlighted.clear();
+	highlightedPositions.clear();
+	hasResult = false;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include <DirectXMath.h>
+#include "RaycastBatch.h"
+
+using namespace DirectX;
+
+class Actor;
+
+//Resolves what the Player's scan visor is looking at. Casts a cone of rays around the view direction,
+//the centre ray picks the scan target and the rest pick up nearby scannables to highlight.
+//Results are kept until the view moves, the level changes or a few frames pass, so a visor held
+//still costs a handful of compares most frames. Cached actors are never dereferenced between casts,
+//they may have been destroyed without any notice reaching the visor.
+class ScanVisor
+{
+public:
+	//Returns false if nothing could have changed since the last update and the cone wasn't cast.
+	bool Update(XMVECTOR origin, XMVECTOR forward, Actor* actorToIgnore);
+	void Reset();
+
+	//Only safe to dereference on a frame Update() returned true, otherwise only good for comparing.
+	Actor* GetTarget() const { return target; }
+	const std::vector<Actor*>& GetHighlighted() const { return highlighted; }
+	//Positions of GetHighlighted() as of the last cast, safe to hold on to past the actors' lifetime.
+	const std::vector<XMFLOAT3>& GetHighlightedPositions() const { return highlightedPositions; }
+
+	float range = 50.f;
+	//Angle from the centre ray to the ring of outer rays, in degrees.
+	float coneAngle = 8.f;
+	//Results are recast at least this often so scannables moving past a still visor are picked up.
+	int maxFramesBetweenCasts = 8;
+
+private:
+	bool NeedsRequery(XMVECTOR origin, XMVECTOR forward);
+
+	RaycastBatch coneBatch;
+
+	Actor* target = nullptr;
+	std::vector<Actor*> highlighted;
+
+	//World state the current results were resolved against.
+	XMFLOAT3 lastOrigin = {};
+	XMFLOAT3 lastForward = {};
+	std::vector<XMFLOAT3> highlightedPositions;
+	uint32_t lastDestroyGeneration = 0;
+	uint32_t lastGridVersion = 0;
+	int framesSinceCast = 0;
+	bool hasResult = false;
+};
@@ -0,0 +1,315 @@
+#include "vpch.h"
+#include "TriggerBroadphase.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "BoundsUtils.h"
+#include "Actors/Actor.h"
+#include "Components/BoxTriggerComponent.h"
+#include "Profiler.h"
+
+const float triggerCellSize = 4.f;
+
+struct TriggerCell
+{
+	int x, y, z;
+};
+
+struct TriggerEntry
+{
+	TriggerBroadphase::TriggerCallback onEnter;
+	TriggerBroadphase::TriggerCallback onExit;
+	//Copied from the trigger on Add() so dirty and candidate checks don't have to read it.
+	Actor* target = nullptr;
+	Actor* owner = nullptr;
+	TriggerCell cellMin;
+	TriggerCell cellMax;
+	uint32_t lastTestedUpdate = 0;
+	bool containsTarget = false;
+};
+
+struct TargetState
+{
+	XMFLOAT3 lastPosition;
+	std::vector<BoxTriggerComponent*> overlappingTriggers;
+};
+
+std::unordered_map<BoxTriggerComponent*, TriggerEntry> triggerEntries;
+std::unordered_map<uint64_t, std::vector<BoxTriggerComponent*>> triggerCells;
+std::unordered_map<Actor*, TargetState> triggerTargets;
+std::unordered_map<Actor*, std::vector<BoxTriggerComponent*>> triggerOwners;
+
+//Triggers added or moved since the last update, tested regardless of where their target is.
+std::vector<BoxTriggerComponent*> dirtyTriggers;
+
+//Reused between updates so a moving target doesn't allocate every frame.
+std::vector<BoxTriggerComponent*> triggerCandidates;
+std::vector<TriggerBroadphase::TriggerCallback> triggerCallbacks;
+
+uint32_t broadphaseUpdateCount = 0;
+
+static TriggerCell PositionToTriggerCell(XMFLOAT3 pos)
+{
+	return { (int)std::floor(pos.x / triggerCellSize),
+		(int)std::floor(pos.y / triggerCellSize),
+		(int)std::floor(pos.z / triggerCellSize) };
+}
+
+static uint64_t HashTriggerCell(TriggerCell cell)
+{
+	//21 bits per axis is plenty for any level's extents in cells.
+	const uint64_t mask = (1ull << 21) - 1;
+	return ((uint64_t)cell.x & mask) | (((uint64_t)cell.y & mask) << 21) | (((uint64_t)cell.z & mask) << 42);
+}
+
+template <typename Func>
+static void ForEachTriggerCell(TriggerCell min, TriggerCell max, Func func)
+{
+	for (int z = min.z; z <= max.z; z++)
+	{
+		for (int y = min.y; y <= max.y; y++)
+		{
+			for (int x = min.x; x <= max.x; x++)
+			{
+				func(HashTriggerCell({ x, y, z }));
+			}
+		}
+	}
+}
+
+static void InsertIntoCells(BoxTriggerComponent* trigger, TriggerEntry& entry)
+{
+	const BoundingBox bounds = BoundsUtils::GetWorldAABB(trigger);
+
+	XMFLOAT3 min, max;
+	XMStoreFloat3(&min, XMLoadFloat3(&bounds.Center) - XMLoadFloat3(&bounds.Extents));
+	XMStoreFloat3(&max, XMLoadFloat3(&bounds.Center) + XMLoadFloat3(&bounds.Extents));
+
+	entry.cellMin = PositionToTriggerCell(min);
+	entry.cellMax = PositionToTriggerCell(max);
+
+	ForEachTriggerCell(entry.cellMin, entry.cellMax, [trigger](uint64_t key) {
+		triggerCells[key].push_back(trigger);
+	});
+}
+
+static void RemoveFromCells(BoxTriggerComponent* trigger, TriggerEntry& entry)
+{
+	ForEachTriggerCell(entry.cellMin, entry.cellMax, [trigger](uint64_t key) {
+		auto cellIt = triggerCells.find(key);
+		if (cellIt == triggerCells.end()) return;
+
+		std::vector<BoxTriggerComponent*>& cellTriggers = cellIt->second;
+		cellTriggers.erase(std::remove(cellTriggers.begin(), cellTriggers.end(), trigger), cellTriggers.end());
+		if (cellTriggers.empty())
+		{
+			triggerCells.erase(cellIt);
+		}
+	});
+}
+
+void TriggerBroadphase::Add(BoxTriggerComponent* trigger, TriggerCallback onEnter, TriggerCallback onExit)
+{
+	if (triggerEntries.find(trigger) != triggerEntries.end())
+	{
+		Remove(trigger);
+	}
+
+	TriggerEntry& entry = triggerEntries[trigger];
+	entry.onEnter = onEnter;
+	entry.onExit = onExit;
+	entry.target = trigger->targetActor;
+	entry.owner = trigger->GetOwner();
+	InsertIntoCells(trigger, entry);
+
+	triggerOwners[entry.owner].push_back(trigger);
+
+	dirtyTriggers.push_back(trigger);
+}
+
+void TriggerBroadphase::Remove(BoxTriggerComponent* trigger)
+{
+	auto entryIt = triggerEntries.find(trigger);
+	if (entryIt == triggerEntries.end()) return;
+
+	RemoveFromCells(trigger, entryIt->second);
+
+	auto ownerIt = triggerOwners.find(entryIt->second.owner);
+	if (ownerIt != triggerOwners.end())
+	{
+		std::vector<BoxTriggerComponent*>& ownedTriggers = ownerIt->second;
+		ownedTriggers.erase(std::remove(ownedTriggers.begin(), ownedTriggers.end(), trigger), ownedTriggers.end());
+		if (ownedTriggers.empty())
+		{
+			triggerOwners.erase(ownerIt);
+		}
+	}
+
+	triggerEntries.erase(entryIt);
+
+	dirtyTriggers.erase(std::remove(dirtyTriggers.begin(), dirtyTriggers.end(), trigger), dirtyTriggers.end());
+
+	for (auto& targetPair : triggerTargets)
+	{
+		std::vector<BoxTriggerComponent*>& overlapping = targetPair.second.overlappingTriggers;
+		overlapping.erase(std::remove(overlapping.begin(), overlapping.end(), trigger), overlapping.end());
+	}
+}
+
+void TriggerBroadphase::RemoveOwnedBy(Actor* owner)
+{
+	auto ownerIt = triggerOwners.find(owner);
+	if (ownerIt == triggerOwners.end()) return;
+
+	//Copied as Remove() edits the owner's list.
+	const std::vector<BoxTriggerComponent*> ownedTriggers = ownerIt->second;
+	for (BoxTriggerComponent* trigger : ownedTriggers)
+	{
+		Remove(trigger);
+	}
+}
+
+void TriggerBroadphase::Refresh(BoxTriggerComponent* trigger)
+{
+	auto entryIt = triggerEntries.find(trigger);
+	if (entryIt == triggerEntries.end()) return;
+
+	RemoveFromCells(trigger, entryIt->second);
+	InsertIntoCells(trigger, entryIt->second);
+
+	dirtyTriggers.push_back(trigger);
+}
+
+void TriggerBroadphase::ShiftOrigin(XMVECTOR offset)
+{
+	triggerCells.clear();
+	for (auto& entryPair : triggerEntries)
+	{
+		InsertIntoCells(entryPair.first, entryPair.second);
+	}
+
+	for (auto& targetPair : triggerTargets)
+	{
+		XMFLOAT3& lastPosition = targetPair.second.lastPosition;
+		XMStoreFloat3(&lastPosition, XMLoadFloat3(&lastPosition) - offset);
+	}
+}
+
+void TriggerBroadphase::UpdateTarget(Actor* target)
+{
+	PROFILE_FUNCTION();
+
+	broadphaseUpdateCount++;
+
+	XMFLOAT3 position;
+	XMStoreFloat3(&position, target->GetPositionV());
+
+	auto targetIt = triggerTargets.find(target);
+	const bool firstUpdate = targetIt == triggerTargets.end();
+	TargetState& state = triggerTargets[target];
+
+	const bool moved = firstUpdate || position.x != state.lastPosition.x ||
+		position.y != state.lastPosition.y || position.z != state.lastPosition.z;
+
+	triggerCandidates.clear();
+
+	auto addCandidate = [&](BoxTriggerComponent* trigger) {
+		auto entryIt = triggerEntries.find(trigger);
+		if (entryIt == triggerEntries.end()) return;
+
+		TriggerEntry& entry = entryIt->second;
+		if (entry.target != target) return;
+
+		if (entry.lastTestedUpdate == broadphaseUpdateCount) return;
+		entry.lastTestedUpdate = broadphaseUpdateCount;
+		triggerCandidates.push_back(trigger);
+	};
+
+	for (BoxTriggerComponent* trigger : dirtyTriggers)
+	{
+		addCandidate(trigger);
+	}
+
+	if (moved)
+	{
+		for (BoxTriggerComponent* trigger : state.overlappingTriggers)
+		{
+			addCandidate(trigger);
+		}
+
+		//Step along the path moved this frame in half cell increments so fast movers don't skip cells.
+		const XMFLOAT3 start = firstUpdate ? position : state.lastPosition;
+		const XMVECTOR from = XMLoadFloat3(&start);
+		const XMVECTOR to = XMLoadFloat3(&position);
+		const float distance = XMVectorGetX(XMVector3Length(to - from));
+		const int stepCount = (int)std::ceil(distance / (triggerCellSize * 0.5f));
+
+		uint64_t lastKey = UINT64_MAX;
+		for (int step = 0; step <= stepCount; step++)
+		{
+			const float t = stepCount > 0 ? (float)step / (float)stepCount : 1.f;
+			XMFLOAT3 samplePos;
+			XMStoreFloat3(&samplePos, XMVectorLerp(from, to, t));
+
+			const uint64_t key = HashTriggerCell(PositionToTriggerCell(samplePos));
+			if (key == lastKey) continue;
+			lastKey = key;
+
+			auto cellIt = triggerCells.find(key);
+			if (cellIt == triggerCells.end()) continue;
+
+			for (BoxTriggerComponent* trigger : cellIt->second)
+			{
+				addCandidate(trigger);
+			}
+		}
+
+		state.lastPosition = position;
+	}
+
+	//Callbacks are fired after all tests as they're free to add or remove triggers.
+	triggerCallbacks.clear();
+
+	for (BoxTriggerComponent* trigger : triggerCandidates)
+	{
+		TriggerEntry& entry = triggerEntries[trigger];
+
+		const bool containsTarget = trigger->ContainsTarget();
+		if (containsTarget == entry.containsTarget) continue;
+
+		entry.containsTarget = containsTarget;
+
+		if (containsTarget)
+		{
+			state.overlappingTriggers.push_back(trigger);
+			if (entry.onEnter) triggerCallbacks.push_back(entry.onEnter);
+		}
+		else
+		{
+			std::vector<BoxTriggerComponent*>& overlapping = state.overlappingTriggers;
+			overlapping.erase(std::remove(overlapping.begin(), overlapping.end(), trigger), overlapping.end());
+			if (entry.onExit) triggerCallbacks.push_back(entry.onExit);
+		}
+	}
+
+	//Only drop the dirty triggers that belonged to this target, the rest wait on their own target.
+	dirtyTriggers.erase(std::remove_if(dirtyTriggers.begin(), dirtyTriggers.end(),
+		[target](BoxTriggerComponent* trigger) { return triggerEntries[trigger].target == target; }), dirtyTriggers.end());
+
+	//Indexed as a callback can remove triggers, but must not update a target itself.
+	for (size_t i = 0; i < triggerCallbacks.size(); i++)
+	{
+		triggerCallbacks[i]();
+	}
+}
+
+void TriggerBroadphase::Reset()
+{
+	triggerEntries.clear();
+	triggerCells.clear();
+	triggerTargets.clear();
+	triggerOwners.clear();
+	dirtyTriggers.clear();
+}
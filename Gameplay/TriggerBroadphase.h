@@ -0,0 +1,37 @@
+#pragma once
+
+#include <functional>
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+class Actor;
+struct BoxTriggerComponent;
+
+//Spatial hash of BoxTriggerComponents that fires enter/exit callbacks for a trigger's targetActor.
+//Only triggers in the hash cells a target moved through that frame (plus the ones it is already
+//inside of) are tested, so idle triggers far from the player cost nothing.
+namespace TriggerBroadphase
+{
+	using TriggerCallback = std::function<void()>;
+
+	//Set the trigger's targetActor before adding it.
+	void Add(BoxTriggerComponent* trigger, TriggerCallback onEnter, TriggerCallback onExit = nullptr);
+	void Remove(BoxTriggerComponent* trigger);
+	//Removes every trigger whose component belongs to owner. Called from the owner's destructor so
+	//no destroy path leaves a dangling trigger behind.
+	void RemoveOwnedBy(Actor* owner);
+
+	//Re-hashes a trigger after it has moved.
+	void Refresh(BoxTriggerComponent* trigger);
+
+	//Re-hashes every trigger after the whole world has been moved by -offset (floating origin) and
+	//moves targets' last positions with it so the shift isn't treated as movement.
+	void ShiftOrigin(XMVECTOR offset);
+
+	//Called by the target actor at the end of its Tick, after it has moved.
+	void UpdateTarget(Actor* target);
+
+	//Drops every trigger. Call before the world is unloaded.
+	void Reset();
+}
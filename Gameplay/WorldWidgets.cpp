@@ -0,0 +1,422 @@
+#include "vpch.h"
+#include "WorldWidgets.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <random>
+#include "Actors/Actor.h"
+#include "Components/CameraComponent.h"
+#include "Render/Renderer.h"
+#include "UI/Game/GameWidget.h"
+#include "DebugCommands.h"
+#include "Profiler.h"
+
+const int anchorsPerLane = 4;
+
+//Anchors this far off screen in pixels still count as on it, so widgets straddling the screen's
+//edges aren't popped early. About half the widest world widget.
+const float worldWidgetScreenMargin = 100.f;
+
+//Anything nearer the camera plane than this is treated as behind it.
+const float minProjectedW = 0.001f;
+
+std::vector<GameWidget*> worldWidgets;
+std::vector<Actor*> worldWidgetAnchors;
+
+//Padded out to a multiple of anchorsPerLane. Padding lanes get a negative max distance so they never pass.
+std::vector<float> anchorPosX, anchorPosY, anchorPosZ;
+std::vector<float> anchorMaxDistanceSq;
+//Written by the cull task for visible anchors, in pixels.
+std::vector<float> anchorScreenX, anchorScreenY;
+
+//View of the last cull, for ProjectToScreen().
+WorldWidgets::CameraView lastCameraView = {};
+std::vector<float> projectPosX, projectPosY, projectPosZ;
+
+std::vector<uint8_t> worldWidgetShown;
+std::vector<uint8_t> worldWidgetInViewport;
+std::vector<uint8_t> worldWidgetVisible;
+
+std::unordered_map<GameWidget*, int> worldWidgetIndices;
+
+int visibleWorldWidgetCount = 0;
+
+template <typename Func>
+static void ForEachAnchorArray(Func func)
+{
+	func(anchorPosX); func(anchorPosY); func(anchorPosZ);
+	func(anchorMaxDistanceSq);
+	func(anchorScreenX); func(anchorScreenY);
+}
+
+static void PadAnchorArrays()
+{
+	const size_t padded = (worldWidgets.size() + anchorsPerLane - 1) / anchorsPerLane * anchorsPerLane;
+	ForEachAnchorArray([padded](std::vector<float>& values) { values.resize(padded, 0.f); });
+
+	for (size_t i = worldWidgets.size(); i < padded; i++)
+	{
+		anchorMaxDistanceSq[i] = -1.f;
+	}
+}
+
+void WorldWidgets::Add(GameWidget* widget, Actor* anchor, float maxDistance)
+{
+	if (worldWidgetIndices.find(widget) != worldWidgetIndices.end())
+	{
+		Remove(widget);
+	}
+
+	const int index = (int)worldWidgets.size();
+	worldWidgetIndices[widget] = index;
+	worldWidgets.push_back(widget);
+	worldWidgetAnchors.push_back(anchor);
+	worldWidgetShown.push_back(false);
+	worldWidgetInViewport.push_back(false);
+	worldWidgetVisible.push_back(false);
+
+	PadAnchorArrays();
+	anchorMaxDistanceSq[index] = maxDistance * maxDistance;
+}
+
+void WorldWidgets::Remove(GameWidget* widget)
+{
+	auto indexIt = worldWidgetIndices.find(widget);
+	if (indexIt == worldWidgetIndices.end()) return;
+
+	const int index = indexIt->second;
+	worldWidgetIndices.erase(indexIt);
+
+	if (worldWidgetInViewport[index])
+	{
+		widget->RemoveFromViewport();
+	}
+
+	//Swap the last widget into the removed slot to keep the arrays packed.
+	const int last = (int)worldWidgets.size() - 1;
+	if (index != last)
+	{
+		worldWidgets[index] = worldWidgets[last];
+		worldWidgetIndices[worldWidgets[index]] = index;
+	}
+	worldWidgets.pop_back();
+
+	auto swapRemove = [index, last](auto& values) {
+		values[index] = values[last];
+		values.pop_back();
+	};
+	swapRemove(worldWidgetAnchors);
+	swapRemove(worldWidgetShown);
+	swapRemove(worldWidgetInViewport);
+	swapRemove(worldWidgetVisible);
+
+	//The float arrays are padded so can't pop, the swapped out slot just becomes padding.
+	ForEachAnchorArray([index, last](std::vector<float>& values) { values[index] = values[last]; });
+	anchorMaxDistanceSq[last] = -1.f;
+	PadAnchorArrays();
+}
+
+void WorldWidgets::RemoveAnchoredTo(Actor* actor)
+{
+	//Backwards as Remove() swaps the last widget into the removed slot.
+	for (int i = (int)worldWidgets.size() - 1; i >= 0; i--)
+	{
+		if (worldWidgetAnchors[i] == actor)
+		{
+			Remove(worldWidgets[i]);
+		}
+	}
+}
+
+void WorldWidgets::SetShown(GameWidget* widget, bool shown)
+{
+	auto indexIt = worldWidgetIndices.find(widget);
+	if (indexIt == worldWidgetIndices.end()) return;
+
+	worldWidgetShown[indexIt->second] = shown;
+}
+
+WorldWidgets::CameraView WorldWidgets::GetCameraView(CameraComponent* camera)
+{
+	CameraView view;
+	XMStoreFloat3(&view.position, camera->GetWorldMatrix().r[3]);
+	XMStoreFloat4x4(&view.viewProjection, camera->GetViewMatrix() * camera->GetProjectionMatrix());
+	view.viewportWidth = Renderer::GetViewportWidth();
+	view.viewportHeight = Renderer::GetViewportHeight();
+	return view;
+}
+
+void WorldWidgets::Update(const CameraView& view)
+{
+	PROFILE_FUNCTION();
+
+	GatherAnchors();
+	GetCullTask(view).run();
+	ApplyCull();
+}
+
+void WorldWidgets::GatherAnchors()
+{
+	PROFILE_FUNCTION();
+
+	for (size_t i = 0; i < worldWidgets.size(); i++)
+	{
+		XMFLOAT3 pos;
+		XMStoreFloat3(&pos, worldWidgetAnchors[i]->GetPositionV());
+		anchorPosX[i] = pos.x;
+		anchorPosY[i] = pos.y;
+		anchorPosZ[i] = pos.z;
+	}
+}
+
+//Projects four points to pixels, row vectors times the view projection as DirectXMath does. Lanes
+//behind the camera or further than the margin off screen come back clear in onScreen.
+static void ProjectFour(const WorldWidgets::CameraView& view, XMVECTOR x, XMVECTOR y, XMVECTOR z,
+	XMVECTOR& screenX, XMVECTOR& screenY, XMVECTOR& onScreen)
+{
+	const XMFLOAT4X4& m = view.viewProjection;
+
+	const XMVECTOR clipX = x * XMVectorReplicate(m._11) + y * XMVectorReplicate(m._21) + z * XMVectorReplicate(m._31) + XMVectorReplicate(m._41);
+	const XMVECTOR clipY = x * XMVectorReplicate(m._12) + y * XMVectorReplicate(m._22) + z * XMVectorReplicate(m._32) + XMVectorReplicate(m._42);
+	const XMVECTOR clipW = x * XMVectorReplicate(m._14) + y * XMVectorReplicate(m._24) + z * XMVectorReplicate(m._34) + XMVectorReplicate(m._44);
+
+	const XMVECTOR inFront = XMVectorGreater(clipW, XMVectorReplicate(minProjectedW));
+	//Lanes behind the camera divide by 1 instead, they're masked out anyway.
+	const XMVECTOR invW = XMVectorReciprocal(XMVectorSelect(XMVectorSplatOne(), clipW, inFront));
+
+	//NDC to pixels, y down.
+	const XMVECTOR halfWidth = XMVectorReplicate(view.viewportWidth * 0.5f);
+	const XMVECTOR halfHeight = XMVectorReplicate(view.viewportHeight * 0.5f);
+	screenX = clipX * invW * halfWidth + halfWidth;
+	screenY = halfHeight - clipY * invW * halfHeight;
+
+	const XMVECTOR margin = XMVectorReplicate(worldWidgetScreenMargin);
+	const XMVECTOR inX = XMVectorAndInt(XMVectorGreaterOrEqual(screenX, -margin),
+		XMVectorLessOrEqual(screenX, XMVectorReplicate(view.viewportWidth + worldWidgetScreenMargin)));
+	const XMVECTOR inY = XMVectorAndInt(XMVectorGreaterOrEqual(screenY, -margin),
+		XMVectorLessOrEqual(screenY, XMVectorReplicate(view.viewportHeight + worldWidgetScreenMargin)));
+	onScreen = XMVectorAndInt(inFront, XMVectorAndInt(inX, inY));
+}
+
+static void CullAnchors(const WorldWidgets::CameraView& view)
+{
+	const int widgetCount = (int)worldWidgets.size();
+
+	const XMVECTOR cx = XMVectorReplicate(view.position.x);
+	const XMVECTOR cy = XMVectorReplicate(view.position.y);
+	const XMVECTOR cz = XMVectorReplicate(view.position.z);
+
+	for (int first = 0; first < widgetCount; first += anchorsPerLane)
+	{
+		const XMVECTOR x = XMLoadFloat4((const XMFLOAT4*)&anchorPosX[first]);
+		const XMVECTOR y = XMLoadFloat4((const XMFLOAT4*)&anchorPosY[first]);
+		const XMVECTOR z = XMLoadFloat4((const XMFLOAT4*)&anchorPosZ[first]);
+		const XMVECTOR maxDistanceSq = XMLoadFloat4((const XMFLOAT4*)&anchorMaxDistanceSq[first]);
+
+		const XMVECTOR dx = x - cx;
+		const XMVECTOR dy = y - cy;
+		const XMVECTOR dz = z - cz;
+		const XMVECTOR inRange = XMVectorLessOrEqual(dx * dx + dy * dy + dz * dz, maxDistanceSq);
+
+		XMVECTOR screenX, screenY, onScreen;
+		ProjectFour(view, x, y, z, screenX, screenY, onScreen);
+		XMStoreFloat4((XMFLOAT4*)&anchorScreenX[first], screenX);
+		XMStoreFloat4((XMFLOAT4*)&anchorScreenY[first], screenY);
+
+		XMUINT4 visibleLanes;
+		XMStoreUInt4(&visibleLanes, XMVectorAndInt(inRange, onScreen));
+		const uint32_t* visibleLane = &visibleLanes.x;
+
+		const int laneCount = std::min(anchorsPerLane, widgetCount - first);
+		for (int lane = 0; lane < laneCount; lane++)
+		{
+			worldWidgetVisible[first + lane] = visibleLane[lane] != 0;
+		}
+	}
+}
+
+JobSystem::SystemTask WorldWidgets::GetCullTask(const CameraView& view)
+{
+	lastCameraView = view;
+
+	JobSystem::SystemTask task;
+	task.name = "WorldWidgets Cull";
+	task.reads = { &anchorPosX, &anchorMaxDistanceSq };
+	task.writes = { &worldWidgetVisible, &anchorScreenX };
+	task.run = [view]() { CullAnchors(view); };
+	return task;
+}
+
+void WorldWidgets::ProjectToScreen(const std::vector<XMFLOAT3>& positions, std::vector<XMFLOAT2>& screenPositions)
+{
+	screenPositions.clear();
+
+	const size_t padded = (positions.size() + anchorsPerLane - 1) / anchorsPerLane * anchorsPerLane;
+	projectPosX.resize(padded);
+	projectPosY.resize(padded);
+	projectPosZ.resize(padded);
+	for (size_t i = 0; i < positions.size(); i++)
+	{
+		projectPosX[i] = positions[i].x;
+		projectPosY[i] = positions[i].y;
+		projectPosZ[i] = positions[i].z;
+	}
+
+	for (size_t first = 0; first < positions.size(); first += anchorsPerLane)
+	{
+		XMVECTOR screenX, screenY, onScreen;
+		ProjectFour(lastCameraView, XMLoadFloat4((const XMFLOAT4*)&projectPosX[first]),
+			XMLoadFloat4((const XMFLOAT4*)&projectPosY[first]), XMLoadFloat4((const XMFLOAT4*)&projectPosZ[first]),
+			screenX, screenY, onScreen);
+
+		XMFLOAT4 laneX, laneY;
+		XMUINT4 onScreenLanes;
+		XMStoreFloat4(&laneX, screenX);
+		XMStoreFloat4(&laneY, screenY);
+		XMStoreUInt4(&onScreenLanes, onScreen);
+
+		const size_t laneCount = std::min((size_t)anchorsPerLane, positions.size() - first);
+		for (size_t lane = 0; lane < laneCount; lane++)
+		{
+			if ((&onScreenLanes.x)[lane] != 0)
+			{
+				screenPositions.push_back({ (&laneX.x)[lane], (&laneY.x)[lane] });
+			}
+		}
+	}
+}
+
+void WorldWidgets::ApplyCull()
+{
+	PROFILE_FUNCTION();
+
+	const int widgetCount = (int)worldWidgets.size();
+
+	visibleWorldWidgetCount = 0;
+
+	for (int i = 0; i < widgetCount; i++)
+	{
+		GameWidget* widget = worldWidgets[i];
+		const bool visible = worldWidgetShown[i] && worldWidgetVisible[i];
+
+		if (visible != (bool)worldWidgetInViewport[i])
+		{
+			if (visible)
+			{
+				widget->AddToViewport();
+			}
+			else
+			{
+				widget->RemoveFromViewport();
+			}
+			worldWidgetInViewport[i] = visible;
+		}
+
+		if (visible)
+		{
+			widget->SetScreenAnchor({ anchorScreenX[i], anchorScreenY[i] });
+			visibleWorldWidgetCount++;
+		}
+	}
+
+	PROFILE_COUNTER("World Widgets Visible", visibleWorldWidgetCount);
+}
+
+int WorldWidgets::GetWidgetCount()
+{
+	return (int)worldWidgets.size();
+}
+
+int WorldWidgets::GetVisibleCount()
+{
+	return visibleWorldWidgetCount;
+}
+
+void WorldWidgets::Reset()
+{
+	worldWidgets.clear();
+	worldWidgetAnchors.clear();
+	worldWidgetShown.clear();
+	worldWidgetInViewport.clear();
+	worldWidgetVisible.clear();
+	worldWidgetIndices.clear();
+	ForEachAnchorArray([](std::vector<float>& values) { values.clear(); });
+	visibleWorldWidgetCount = 0;
+}
+
+//Projects random points around a camera four at a time and checks the screen positions and on screen
+//lanes match transforming each point on its own with XMVector3TransformCoord().
+static DebugCommands::Registration worldWidgetsProjectionCommand("WorldWidgetsProjection", []() {
+	const XMVECTOR eye = XMVectorSet(3.f, 2.f, -10.f, 1.f);
+	const XMMATRIX viewProjection = XMMatrixLookAtLH(eye, XMVectorSet(0.f, 0.f, 0.f, 1.f), XMVectorSet(0.f, 1.f, 0.f, 0.f)) *
+		XMMatrixPerspectiveFovLH(XMConvertToRadians(70.f), 16.f / 9.f, 0.1f, 1000.f);
+
+	WorldWidgets::CameraView view;
+	XMStoreFloat3(&view.position, eye);
+	XMStoreFloat4x4(&view.viewProjection, viewProjection);
+	view.viewportWidth = 1280.f;
+	view.viewportHeight = 720.f;
+
+	std::mt19937 random(24);
+	std::uniform_real_distribution<float> coordinate(-30.f, 30.f);
+
+	int failures = 0;
+	int onScreenCount = 0;
+	for (int i = 0; i < 10000; i += anchorsPerLane)
+	{
+		XMFLOAT4 x, y, z;
+		for (int lane = 0; lane < anchorsPerLane; lane++)
+		{
+			(&x.x)[lane] = coordinate(random);
+			(&y.x)[lane] = coordinate(random);
+			(&z.x)[lane] = coordinate(random);
+		}
+
+		XMVECTOR screenX, screenY, onScreen;
+		ProjectFour(view, XMLoadFloat4(&x), XMLoadFloat4(&y), XMLoadFloat4(&z), screenX, screenY, onScreen);
+
+		XMFLOAT4 laneX, laneY;
+		XMUINT4 onScreenLanes;
+		XMStoreFloat4(&laneX, screenX);
+		XMStoreFloat4(&laneY, screenY);
+		XMStoreUInt4(&onScreenLanes, onScreen);
+
+		for (int lane = 0; lane < anchorsPerLane; lane++)
+		{
+			const XMVECTOR point = XMVectorSet((&x.x)[lane], (&y.x)[lane], (&z.x)[lane], 1.f);
+			const XMVECTOR clip = XMVector4Transform(point, viewProjection);
+			const XMVECTOR ndc = XMVector3TransformCoord(point, viewProjection);
+
+			const float expectedX = (XMVectorGetX(ndc) * 0.5f + 0.5f) * view.viewportWidth;
+			const float expectedY = (0.5f - XMVectorGetY(ndc) * 0.5f) * view.viewportHeight;
+			const bool expectedOnScreen = XMVectorGetW(clip) > minProjectedW &&
+				expectedX >= -worldWidgetScreenMargin && expectedX <= view.viewportWidth + worldWidgetScreenMargin &&
+				expectedY >= -worldWidgetScreenMargin && expectedY <= view.viewportHeight + worldWidgetScreenMargin;
+
+			const bool laneOnScreen = (&onScreenLanes.x)[lane] != 0;
+			onScreenCount += laneOnScreen;
+
+			//Points right on the margin can round either way.
+			const bool nearEdge = std::abs(expectedX + worldWidgetScreenMargin) < 0.01f ||
+				std::abs(expectedX - view.viewportWidth - worldWidgetScreenMargin) < 0.01f ||
+				std::abs(expectedY + worldWidgetScreenMargin) < 0.01f ||
+				std::abs(expectedY - view.viewportHeight - worldWidgetScreenMargin) < 0.01f;
+
+			if ((laneOnScreen != expectedOnScreen && !nearEdge) ||
+				(expectedOnScreen && (std::abs((&laneX.x)[lane] - expectedX) > 0.01f || std::abs((&laneY.x)[lane] - expectedY) > 0.01f)))
+			{
+				if (failures++ < 5)
+				{
+					Log("Point (%.2f, %.2f, %.2f) projected to (%.2f, %.2f) %s, expected (%.2f, %.2f) %s.",
+						(&x.x)[lane], (&y.x)[lane], (&z.x)[lane], (&laneX.x)[lane], (&laneY.x)[lane],
+						laneOnScreen ? "on screen" : "off screen", expectedX, expectedY, expectedOnScreen ? "on screen" : "off screen");
+				}
+			}
+		}
+	}
+
+	Log("WorldWidgetsProjection: %d of 10000 points on screen.", onScreenCount);
+	return failures == 0;
+});
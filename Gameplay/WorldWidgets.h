@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+#include <DirectXMath.h>
+#include "JobSystem.h"
+
+using namespace DirectX;
+
+class Actor;
+class GameWidget;
+struct CameraComponent;
+
+//Widgets anchored to actors in the world (enemy health bars, player notes). Every anchor is
+//projected to the screen four at a time in one pass per frame, culled against the screen's edges
+//and a max distance, and only the widgets that survive are kept in the viewport with their screen
+//anchor refreshed. Widgets lay themselves out around that anchor, the engine never projects them.
+namespace WorldWidgets
+{
+	const float defaultMaxDistance = 60.f;
+
+	//Everything the projection needs from the camera, copied so the cull task doesn't touch it.
+	struct CameraView
+	{
+		XMFLOAT3 position;
+		XMFLOAT4X4 viewProjection;
+		float viewportWidth;
+		float viewportHeight;
+	};
+
+	CameraView GetCameraView(CameraComponent* camera);
+
+	//widget's screen anchor follows anchor from the next Update. Added hidden, see SetShown().
+	void Add(GameWidget* widget, Actor* anchor, float maxDistance = defaultMaxDistance);
+	//Also takes the widget out of the viewport.
+	void Remove(GameWidget* widget);
+	//Removes every widget anchored to actor. Anchoring actors call this from their destructor so no
+	//destroy path leaves a widget following a dead actor.
+	void RemoveAnchoredTo(Actor* actor);
+
+	//Whether gameplay wants the widget up at all. Culling only ever hides a shown widget.
+	void SetShown(GameWidget* widget, bool shown);
+
+	//Called once per frame after the camera has moved. Same as running the three steps below in a row.
+	void Update(const CameraView& view);
+
+	//Update() split up so the cull can run alongside other systems' tasks. GatherAnchors() reads the
+	//anchors' positions on the game thread, the task projects and culls them without touching the
+	//world, and ApplyCull() adds and removes widgets from the viewport.
+	void GatherAnchors();
+	JobSystem::SystemTask GetCullTask(const CameraView& view);
+	void ApplyCull();
+
+	//Projects positions with the view of the last cull, four at a time, keeping the ones that land
+	//on screen. For widgets marking several world points at once.
+	void ProjectToScreen(const std::vector<XMFLOAT3>& positions, std::vector<XMFLOAT2>& screenPositions);
+
+	int GetWidgetCount();
+	int GetVisibleCount();
+
+	//Forgets every widget without touching the viewport. Call before the world is unloaded.
+	void Reset();
+}
@@ -1,10 +1,16 @@
 #include "vpch.h"
 #include "ClientSalvageMenu.h"
-#include "Gameplay/MissionSystem.h"
-#include "Gameplay/Mission.h"
+#include <algorithm>
+#include "Gameplay/Game/Profiler.h"
+#include "Gameplay/Game/GameInput.h"
+
+static const float missionRowHeight = 30.f;
 
 void ClientSalvageMenu::Draw(float deltaTime)
 {
+	PROFILE_FUNCTION();
+	PROFILE_COUNTER("Widgets Drawn", 1);
+
 	DrawMissionSelectMenu();
 	DrawMissionDetails();
 }
@@ -14,13 +20,74 @@ void ClientSalvageMenu::DrawMissionSelectMenu()
 	Layout selectMenuLayout = PercentAlignLayout(0.1f, 0.1f, 0.45f, 0.9f);
 	FillRect(selectMenuLayout);
 
+	const float menuBottom = selectMenuLayout.rect.bottom;
+
 	selectMenuLayout.PushToTop();
-	selectMenuLayout.rect.bottom += 30.f;
+	selectMenuLayout.rect.bottom += missionRowHeight;
+
+	static const std::wstring sortByRewardLabel = L"Sort: Reward";
+	static const std::wstring sortByClientLabel = L"Sort: Client";
+	if (Button(sortOrder == MissionSortOrder::RewardHighToLow ? sortByRewardLabel : sortByClientLabel, selectMenuLayout))
+	{
+		sortOrder = sortOrder == MissionSortOrder::RewardHighToLow ?
+			MissionSortOrder::ClientThenName : MissionSortOrder::RewardHighToLow;
+		firstVisibleRow = 0;
+	}
+
+	selectMenuLayout.rect.top += missionRowHeight;
+	selectMenuLayout.rect.bottom += missionRowHeight;
+
+	const std::vector<std::wstring>& clients = MissionCatalogue::GetClients();
+	if (clientFilterIndex >= (int)clients.size())
+	{
+		clientFilterIndex = -1;
+	}
+
+	static const std::wstring allClients;
+	static const std::wstring allClientsLabel = L"Client: All";
+	const std::wstring& clientFilter = clientFilterIndex < 0 ? allClients : clients[clientFilterIndex];
+	if (Button(clientFilterIndex < 0 ? allClientsLabel : clientFilter, selectMenuLayout))
+	{
+		clientFilterIndex = clientFilterIndex + 1 < (int)clients.size() ? clientFilterIndex + 1 : -1;
+		firstVisibleRow = 0;
+	}
+
+	selectMenuLayout.rect.top += missionRowHeight;
+	selectMenuLayout.rect.bottom += missionRowHeight;
 
-	if (Button(L"Test Mission", selectMenuLayout))
+	const std::vector<MissionID>& missionIDs = MissionCatalogue::Query(sortOrder, clientFilter);
+
+	//Only the rows that fit are laid out, however many missions match.
+	const int visibleRowCount = std::max(1, (int)((menuBottom - selectMenuLayout.rect.top) / missionRowHeight));
+	ScrollInput(visibleRowCount, (int)missionIDs.size());
+
+	const int lastRow = std::min(firstVisibleRow + visibleRowCount, (int)missionIDs.size());
+	for (int row = firstVisibleRow; row < lastRow; row++)
+	{
+		const MissionEntry* mission = MissionCatalogue::Get(missionIDs[row]);
+
+		if (Button(mission->listLabel, selectMenuLayout))
+		{
+			selectedMissionID = mission->id;
+		}
+
+		selectMenuLayout.rect.top += missionRowHeight;
+		selectMenuLayout.rect.bottom += missionRowHeight;
+	}
+}
+
+void ClientSalvageMenu::ScrollInput(int visibleRowCount, int rowCount)
+{
+	if (GameInput::GetKeyDown(Keys::Down))
+	{
+		firstVisibleRow++;
+	}
+	else if (GameInput::GetKeyDown(Keys::Up))
 	{
-		selectedMission = MissionSystem::FindMission(L"Test Mission");
+		firstVisibleRow--;
 	}
+
+	firstVisibleRow = std::max(0, std::min(firstVisibleRow, rowCount - visibleRowCount));
 }
 
 void ClientSalvageMenu::DrawMissionDetails()
@@ -28,11 +95,15 @@ void ClientSalvageMenu::DrawMissionDetails()
 	Layout selectedMissionLayout = PercentAlignLayout(0.55f, 0.1f, 0.9f, 0.9f);
 	FillRect(selectedMissionLayout);
 
+	const MissionEntry* selectedMission = MissionCatalogue::Get(selectedMissionID);
 	if (selectedMission)
 	{
 		Text(selectedMission->name, selectedMissionLayout);
 		selectedMissionLayout.AddVerticalSpace(30.f);
 
+		Text(selectedMission->client, selectedMissionLayout);
+		selectedMissionLayout.AddVerticalSpace(30.f);
+
 		Text(selectedMission->details, selectedMissionLayout);
 	}
 }
@@ -1,11 +1,10 @@
 #pragma once
 
-#include "../Widget.h"
-
-struct Mission;
+#include "GameWidget.h"
+#include "Gameplay/Game/MissionCatalogue.h"
 
 //Menu to show current undertakable salvage missions.
-class ClientSalvageMenu : public Widget
+class ClientSalvageMenu : public GameWidget
 {
 public:
 	virtual void Draw(float deltaTime) override;
@@ -13,6 +12,14 @@ public:
 private:
 	void DrawMissionSelectMenu();
 	void DrawMissionDetails();
+	void ScrollInput(int visibleRowCount, int rowCount);
+
+	MissionID selectedMissionID = INVALID_MISSION_ID;
+
+	//Index into the current query of the first row shown.
+	int firstVisibleRow = 0;
 
-	Mission* selectedMission = nullptr;
+	MissionSortOrder sortOrder = MissionSortOrder::RewardHighToLow;
+	//-1 shows every client, otherwise an index into MissionCatalogue::GetClients().
+	int clientFilterIndex = -1;
 };
@@ -1,11 +1,17 @@
 #include "vpch.h"
 #include "DialogueWidget.h"
+#include "Gameplay/Game/Profiler.h"
 
 void DialogueWidget::Draw(float deltaTime)
 {
-	Layout layout = PercentAlignLayout(0.1f, 0.6f, 0.9f, 0.9f);
-	FillRect(layout);
-	Text(speakerName, layout, TextAlign::Justified);
-	layout.AddVerticalSpace(30.f);
-	Text(dialogueText, layout, TextAlign::Justified);
+	PROFILE_FUNCTION();
+	PROFILE_COUNTER("Widgets Drawn", 1);
+
+	DrawRetained(dialogueBinding.Update(dialogueVersion), [this]() {
+		Layout layout = PercentAlignLayout(0.1f, 0.6f, 0.9f, 0.9f);
+		FillRect(layout);
+		Text(speakerName, layout, TextAlign::Justified);
+		layout.AddVerticalSpace(30.f);
+		Text(dialogueText, layout, TextAlign::Justified);
+	});
 }
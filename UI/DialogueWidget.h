@@ -1,13 +1,31 @@
 #pragma once
 
-#include "../Widget.h"
+#include "GameWidget.h"
+#include "WidgetBinding.h"
 
 //Shows on screen dialogue from a character in-game.
-class DialogueWidget : public Widget
+class DialogueWidget : public GameWidget
 {
 public:
 	virtual void Draw(float deltaTime) override;
 
+	void SetSpeakerName(const std::wstring& speakerName_)
+	{
+		speakerName = speakerName_;
+		dialogueVersion++;
+	}
+
+	void SetDialogueText(const std::wstring& dialogueText_)
+	{
+		dialogueText = dialogueText_;
+		dialogueVersion++;
+	}
+
+private:
 	std::wstring speakerName;
 	std::wstring dialogueText;
+
+	//Bumped when either string is set, the binding then doesn't compare the text each frame.
+	uint32_t dialogueVersion = 0;
+	WidgetBinding<uint32_t> dialogueBinding;
 };
@@ -1,10 +1,16 @@
 #include "vpch.h"
 #include "EnemyHealthWidget.h"
+#include "Gameplay/Game/Profiler.h"
 
 void EnemyHealthWidget::Draw(float deltaTime)
 {
-	Layout layout = CenterLayoutOnScreenSpaceCoords(100.f, 50.f);
+	PROFILE_FUNCTION();
+	PROFILE_COUNTER("Widgets Drawn", 1);
 
-	FillRect(layout);
-	Text(std::to_wstring(healthPoints), layout);
+	DrawRetained(healthPointsBinding.Update(healthPoints), [this]() {
+		Layout layout = CenterLayoutOnScreenAnchor(100.f, 50.f);
+
+		FillRect(layout);
+		Text(std::to_wstring(healthPoints), layout);
+	});
 }
@@ -1,11 +1,15 @@
 #pragma once
 
-#include "../Widget.h"
+#include "GameWidget.h"
+#include "WidgetBinding.h"
 
-class EnemyHealthWidget : public Widget
+class EnemyHealthWidget : public GameWidget
 {
 public:
 	virtual void Draw(float deltaTime) override;
 
 	int healthPoints = 0;
+
+private:
+	WidgetBinding<int> healthPointsBinding;
 };
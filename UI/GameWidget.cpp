@@ -0,0 +1,83 @@
+#include "vpch.h"
+#include "GameWidget.h"
+#include "WidgetBinding.h"
+
+bool GameWidget::ReplayRetained(bool changed)
+{
+	const Layout viewport = PercentAlignLayout(0.f, 0.f, 1.f, 1.f);
+	const float viewportWidth = viewport.rect.right - viewport.rect.left;
+	const float viewportHeight = viewport.rect.bottom - viewport.rect.top;
+
+	if (changed || !retainedValid || viewportWidth != retainedViewportWidth || viewportHeight != retainedViewportHeight)
+	{
+		retainedViewportWidth = viewportWidth;
+		retainedViewportHeight = viewportHeight;
+		WidgetCacheStats::RecordRebuild();
+		return false;
+	}
+
+	WidgetCacheStats::RecordHit();
+
+	//Whole pixels, as CenterLayoutOnScreenAnchor() snaps them.
+	const float offsetX = std::round(screenAnchor.x - retainedAnchor.x);
+	const float offsetY = std::round(screenAnchor.y - retainedAnchor.y);
+
+	for (size_t i = 0; i < retainedCommandCount; i++)
+	{
+		const RetainedCommand& command = retainedCommands[i];
+
+		Layout layout = command.layout;
+		layout.rect.left += offsetX;
+		layout.rect.right += offsetX;
+		layout.rect.top += offsetY;
+		layout.rect.bottom += offsetY;
+
+		switch (command.kind)
+		{
+		case RetainedKind::FillRect:
+			FillRect(layout);
+			break;
+		case RetainedKind::FillRectColored:
+			FillRect(layout, command.color, command.opacity);
+			break;
+		case RetainedKind::Text:
+			Text(command.text, layout);
+			break;
+		case RetainedKind::TextAligned:
+			Text(command.text, layout, command.align);
+			break;
+		case RetainedKind::Image:
+			Image(command.filename, layout);
+			break;
+		}
+	}
+
+	return true;
+}
+
+void GameWidget::BeginRetained()
+{
+	retainedCommandCount = 0;
+	retainedAnchor = screenAnchor;
+	recordingRetained = true;
+}
+
+void GameWidget::EndRetained()
+{
+	recordingRetained = false;
+	retainedValid = true;
+}
+
+GameWidget::RetainedCommand& GameWidget::Retain(RetainedKind kind, const Layout& layout)
+{
+	if (retainedCommandCount == retainedCommands.size())
+	{
+		retainedCommands.push_back({ kind, layout });
+		return retainedCommands[retainedCommandCount++];
+	}
+
+	RetainedCommand& command = retainedCommands[retainedCommandCount++];
+	command.kind = kind;
+	command.layout = layout;
+	return command;
+}
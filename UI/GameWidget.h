@@ -0,0 +1,210 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../Widget.h"
+#include "UIDrawList.h"
+#include "TextLayoutCache.h"
+#include "Gameplay/Game/Profiler.h"
+
+//Base for the game's widgets. While UIDrawList is recording (see UIDrawListWidget) rects, text and
+//images go into it and are drawn batched once every widget has drawn, otherwise they go straight to
+//Widget's helpers. Justified text is drawn from TextLayoutCache's glyphs while recording. Buttons
+//draw as they're checked for clicks, so they submit everything recorded before them and draw right
+//away. Calls reaching the engine directly count under "UI Draw Calls", UIDrawList counts its own
+//batches.
+//
+//Widgets can also draw retained: DrawRetained() records the draw calls its build function makes and
+//replays them on later frames until the widget says a bound value changed or the viewport resizes.
+//World anchored widgets' recordings follow their screen anchor.
+class GameWidget : public Widget
+{
+public:
+	//Pixel position of the world point this widget is anchored to, set by WorldWidgets each frame it's
+	//visible. Widgets lay out around it rather than having the engine project pos.
+	void SetScreenAnchor(XMFLOAT2 anchor) { screenAnchor = anchor; }
+
+protected:
+	//Widget::FillRect()'s own default colour.
+	static constexpr D2D1_COLOR_F defaultFillColor = { 0.5f, 0.5f, 0.5f, 1.f };
+	//Assumed to match the engine's text brush.
+	static constexpr UIColor defaultTextColor = 0xFFFFFFFF;
+
+	template <typename Build>
+	void DrawRetained(bool changed, Build&& build)
+	{
+		if (ReplayRetained(changed)) return;
+
+		BeginRetained();
+		build();
+		EndRetained();
+	}
+
+	//Next DrawRetained() rebuilds whether or not anything changed.
+	void InvalidateRetained() { retainedValid = false; }
+
+	void FillRect(Layout layout)
+	{
+		if (recordingRetained) Retain(RetainedKind::FillRect, layout);
+
+		if (UIDrawList::IsRecording())
+		{
+			UIDrawList::AddRect(ToUIRect(layout), ToUIColor(defaultFillColor, 1.f));
+			return;
+		}
+
+		PROFILE_COUNTER("UI Draw Calls", 1);
+		Widget::FillRect(layout);
+	}
+
+	void FillRect(Layout layout, D2D1_COLOR_F color, float opacity)
+	{
+		if (recordingRetained)
+		{
+			RetainedCommand& command = Retain(RetainedKind::FillRectColored, layout);
+			command.color = color;
+			command.opacity = opacity;
+		}
+
+		if (UIDrawList::IsRecording())
+		{
+			UIDrawList::AddRect(ToUIRect(layout), ToUIColor(color, opacity));
+			return;
+		}
+
+		PROFILE_COUNTER("UI Draw Calls", 1);
+		Widget::FillRect(layout, color, opacity);
+	}
+
+	void Text(const std::wstring& text, Layout layout)
+	{
+		if (recordingRetained) Retain(RetainedKind::Text, layout).text = text;
+
+		if (UIDrawList::IsRecording())
+		{
+			UIDrawList::AddEngineText(ToUIRect(layout), text, -1);
+			return;
+		}
+
+		PROFILE_COUNTER("UI Draw Calls", 1);
+		Widget::Text(text, layout);
+	}
+
+	void Text(const std::wstring& text, Layout layout, TextAlign align)
+	{
+		if (recordingRetained)
+		{
+			RetainedCommand& command = Retain(RetainedKind::TextAligned, layout);
+			command.text = text;
+			command.align = align;
+		}
+
+		if (UIDrawList::IsRecording())
+		{
+			//Justified text is wrapped and positioned game side, so it's only laid out when it changes.
+			if (align == TextAlign::Justified &&
+				TextLayoutCache::Draw(text, ToUIRect(layout), TextLayoutAlign::Justified, defaultTextColor))
+			{
+				return;
+			}
+
+			UIDrawList::AddEngineText(ToUIRect(layout), text, (int)align);
+			return;
+		}
+
+		PROFILE_COUNTER("UI Draw Calls", 1);
+		Widget::Text(text, layout, align);
+	}
+
+	void Image(const std::string& filename, Layout layout)
+	{
+		if (recordingRetained) Retain(RetainedKind::Image, layout).filename = filename;
+
+		if (UIDrawList::IsRecording())
+		{
+			UIDrawList::AddEngineImage(ToUIRect(layout), filename);
+			return;
+		}
+
+		PROFILE_COUNTER("UI Draw Calls", 1);
+		Widget::Image(filename, layout);
+	}
+
+	//Not retained, a button has to be checked for clicks every frame.
+	template <typename... Args>
+	bool Button(Args&&... args)
+	{
+		UIDrawList::Flush();
+		PROFILE_COUNTER("UI Draw Calls", 1);
+		return Widget::Button(std::forward<Args>(args)...);
+	}
+
+	//width x height centred on the screen anchor, snapped to whole pixels.
+	Layout CenterLayoutOnScreenAnchor(float width, float height)
+	{
+		const float left = std::round(screenAnchor.x - width * 0.5f);
+		const float top = std::round(screenAnchor.y - height * 0.5f);
+		return RectLayout({ left, top, left + width, top + height });
+	}
+
+	Layout RectLayout(const UIRect& rect)
+	{
+		//Any layout will do, only its rect is drawn with.
+		Layout layout = PercentAlignLayout(0.f, 0.f, 1.f, 1.f);
+		layout.rect = D2D1::RectF(rect.left, rect.top, rect.right, rect.bottom);
+		return layout;
+	}
+
+private:
+	enum class RetainedKind : uint8_t
+	{
+		FillRect,
+		FillRectColored,
+		Text,
+		TextAligned,
+		Image,
+	};
+
+	//One recorded draw call, with whatever of its arguments its kind uses.
+	struct RetainedCommand
+	{
+		RetainedKind kind;
+		Layout layout;
+		D2D1_COLOR_F color;
+		float opacity;
+		TextAlign align;
+		std::wstring text;
+		std::string filename;
+	};
+
+	//True if the recording was replayed and building can be skipped.
+	bool ReplayRetained(bool changed);
+	void BeginRetained();
+	void EndRetained();
+	RetainedCommand& Retain(RetainedKind kind, const Layout& layout);
+
+	static UIRect ToUIRect(const Layout& layout)
+	{
+		return { layout.rect.left, layout.rect.top, layout.rect.right, layout.rect.bottom };
+	}
+
+	//Opacity is folded into alpha, as a brush's opacity multiplies its colour's.
+	static UIColor ToUIColor(D2D1_COLOR_F color, float opacity)
+	{
+		return MakeUIColor(color.r, color.g, color.b, color.a * opacity);
+	}
+
+	XMFLOAT2 screenAnchor = {};
+
+	//Commands past retainedCommandCount are kept so their strings' buffers are reused.
+	std::vector<RetainedCommand> retainedCommands;
+	size_t retainedCommandCount = 0;
+	bool recordingRetained = false;
+	bool retainedValid = false;
+	//Screen anchor and viewport size when recorded.
+	XMFLOAT2 retainedAnchor = {};
+	float retainedViewportWidth = 0.f;
+	float retainedViewportHeight = 0.f;
+};
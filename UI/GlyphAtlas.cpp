@@ -0,0 +1,179 @@
+#include "vpch.h"
+#include "GlyphAtlas.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <unordered_map>
+#include "GlyphRasterizer.h"
+#include "Gameplay/Game/Profiler.h"
+
+struct AtlasFont
+{
+	std::wstring family;
+	float size;
+	GlyphAtlas::FontMetrics metrics;
+	//Indices into atlasGlyphs, -1 until first drawn. ASCII skips the map.
+	std::array<int32_t, 128> asciiGlyphs;
+	std::unordered_map<wchar_t, int32_t> otherGlyphs;
+};
+
+std::vector<AtlasFont> atlasFonts;
+std::vector<GlyphAtlas::Glyph> atlasGlyphs;
+std::vector<GlyphAtlas::Page> atlasPages;
+
+//Shelf being filled on the last page.
+int atlasShelfX = 0;
+int atlasShelfY = 0;
+int atlasShelfHeight = 0;
+
+//Keeps linear filtering from bleeding neighbouring glyphs in.
+const int atlasGlyphPadding = 1;
+
+static UITextureID PageToTexture(size_t pageIndex)
+{
+	return (UITextureID)(pageIndex + 1);
+}
+
+//Finds room for a width x height rect, starting a new shelf or page when the current one is full.
+static bool AllocateGlyphRect(int width, int height, int& x, int& y)
+{
+	const int paddedWidth = width + atlasGlyphPadding;
+	const int paddedHeight = height + atlasGlyphPadding;
+	if (paddedWidth > GlyphAtlas::pageSize || paddedHeight > GlyphAtlas::pageSize) return false;
+
+	if (!atlasPages.empty() && atlasShelfX + paddedWidth > GlyphAtlas::pageSize)
+	{
+		atlasShelfY += atlasShelfHeight;
+		atlasShelfX = 0;
+		atlasShelfHeight = 0;
+	}
+
+	if (atlasPages.empty() || atlasShelfY + paddedHeight > GlyphAtlas::pageSize)
+	{
+		GlyphAtlas::Page page;
+		page.alpha.assign((size_t)GlyphAtlas::pageSize * GlyphAtlas::pageSize, 0);
+		page.version = 0;
+		atlasPages.push_back(std::move(page));
+
+		atlasShelfX = 0;
+		atlasShelfY = 0;
+		atlasShelfHeight = 0;
+	}
+
+	x = atlasShelfX;
+	y = atlasShelfY;
+	atlasShelfX += paddedWidth;
+	atlasShelfHeight = std::max(atlasShelfHeight, paddedHeight);
+	return true;
+}
+
+static GlyphAtlas::Glyph AddGlyph(const AtlasFont& font, wchar_t character)
+{
+	PROFILE_FUNCTION();
+
+	GlyphAtlas::Glyph glyph = {};
+
+	GlyphRasterizer::GlyphBitmap bitmap;
+	if (!GlyphRasterizer::Rasterize(font.family, font.size, character, bitmap))
+	{
+		//Still takes up space so the rest of the line doesn't close up over it.
+		glyph.advance = font.size * 0.5f;
+		return glyph;
+	}
+
+	glyph.advance = bitmap.advance;
+	if (bitmap.width == 0) return glyph;
+
+	int x, y;
+	if (!AllocateGlyphRect(bitmap.width, bitmap.height, x, y))
+	{
+		Log("Glyph %u at size %.1f is too big for the glyph atlas.", (unsigned)character, font.size);
+		return glyph;
+	}
+
+	GlyphAtlas::Page& page = atlasPages.back();
+	for (int row = 0; row < bitmap.height; row++)
+	{
+		std::memcpy(&page.alpha[(size_t)(y + row) * GlyphAtlas::pageSize + x], &bitmap.alpha[(size_t)row * bitmap.width], bitmap.width);
+	}
+	page.version++;
+
+	const float texel = 1.f / GlyphAtlas::pageSize;
+	glyph.offsetX = (float)bitmap.offsetX;
+	glyph.offsetY = (float)bitmap.offsetY;
+	glyph.width = (float)bitmap.width;
+	glyph.height = (float)bitmap.height;
+	glyph.uv = { x * texel, y * texel, (x + bitmap.width) * texel, (y + bitmap.height) * texel };
+	glyph.texture = PageToTexture(atlasPages.size() - 1);
+	return glyph;
+}
+
+UIFontID GlyphAtlas::GetFont(const std::wstring& family, float size)
+{
+	for (size_t i = 0; i < atlasFonts.size(); i++)
+	{
+		if (atlasFonts[i].size == size && atlasFonts[i].family == family)
+		{
+			return (UIFontID)i;
+		}
+	}
+
+	GlyphRasterizer::FontMetrics metrics;
+	if (!GlyphRasterizer::GetFontMetrics(family, size, metrics))
+	{
+		return INVALID_UI_FONT;
+	}
+
+	AtlasFont font;
+	font.family = family;
+	font.size = size;
+	font.metrics.ascent = metrics.ascent;
+	font.metrics.lineHeight = metrics.ascent + metrics.descent + metrics.lineGap;
+	font.asciiGlyphs.fill(-1);
+	atlasFonts.push_back(std::move(font));
+	return (UIFontID)(atlasFonts.size() - 1);
+}
+
+const GlyphAtlas::FontMetrics& GlyphAtlas::GetFontMetrics(UIFontID font)
+{
+	return atlasFonts[font].metrics;
+}
+
+const GlyphAtlas::Glyph& GlyphAtlas::GetGlyph(UIFontID fontID, wchar_t character)
+{
+	AtlasFont& font = atlasFonts[fontID];
+
+	int32_t* glyphIndex = nullptr;
+	if (character < 128)
+	{
+		glyphIndex = &font.asciiGlyphs[character];
+	}
+	else
+	{
+		glyphIndex = &font.otherGlyphs.emplace(character, -1).first->second;
+	}
+
+	if (*glyphIndex < 0)
+	{
+		atlasGlyphs.push_back(AddGlyph(font, character));
+		*glyphIndex = (int32_t)(atlasGlyphs.size() - 1);
+	}
+
+	return atlasGlyphs[*glyphIndex];
+}
+
+const GlyphAtlas::Page* GlyphAtlas::GetPage(UITextureID texture)
+{
+	if (texture == UI_NO_TEXTURE || texture > atlasPages.size()) return nullptr;
+	return &atlasPages[texture - 1];
+}
+
+int GlyphAtlas::GetPageCount()
+{
+	return (int)atlasPages.size();
+}
+
+int GlyphAtlas::GetGlyphCount()
+{
+	return (int)atlasGlyphs.size();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "UIDrawList.h"
+
+using UIFontID = uint16_t;
+const UIFontID INVALID_UI_FONT = UINT16_MAX;
+
+//Glyphs rasterised on the CPU the first time they're drawn and packed into alpha pages, shelf by
+//shelf. Pages are UIDrawList textures, so text drawn from them batches with everything else using
+//the same page.
+namespace GlyphAtlas
+{
+	const int pageSize = 1024;
+
+	struct Glyph
+	{
+		//Pixel rect relative to the pen position on the baseline, empty for whitespace.
+		float offsetX, offsetY;
+		float width, height;
+		UIRect uv;
+		UITextureID texture;
+		float advance;
+	};
+
+	struct Page
+	{
+		//One coverage byte per texel, pageSize square.
+		std::vector<uint8_t> alpha;
+		//Bumped whenever a glyph is added, so backends know to upload it again.
+		uint32_t version;
+	};
+
+	struct FontMetrics
+	{
+		float ascent;
+		float lineHeight;
+	};
+
+	//INVALID_UI_FONT if the family isn't installed.
+	UIFontID GetFont(const std::wstring& family, float size);
+	const FontMetrics& GetFontMetrics(UIFontID font);
+
+	//Rasterised on first use. Valid until the next GetGlyph().
+	const Glyph& GetGlyph(UIFontID font, wchar_t character);
+
+	//Null for anything that isn't a page's texture.
+	const Page* GetPage(UITextureID texture);
+	int GetPageCount();
+	int GetGlyphCount();
+}
@@ -0,0 +1,132 @@
+#include "vpch.h"
+#include "GlyphRasterizer.h"
+#include <unordered_map>
+#include <dwrite.h>
+#include <wrl/client.h>
+
+using Microsoft::WRL::ComPtr;
+
+ComPtr<IDWriteFactory> glyphWriteFactory;
+std::unordered_map<std::wstring, ComPtr<IDWriteFontFace>> glyphFontFaces;
+
+static IDWriteFontFace* GetFontFace(const std::wstring& family)
+{
+	auto faceIt = glyphFontFaces.find(family);
+	if (faceIt != glyphFontFaces.end())
+	{
+		return faceIt->second.Get();
+	}
+
+	//Misses are cached too so a missing family is only looked for once.
+	ComPtr<IDWriteFontFace>& face = glyphFontFaces[family];
+
+	if (!glyphWriteFactory &&
+		FAILED(DWriteCreateFactory(DWRITE_FACTORY_TYPE_SHARED, __uuidof(IDWriteFactory),
+		reinterpret_cast<IUnknown**>(glyphWriteFactory.GetAddressOf()))))
+	{
+		Log("Couldn't create DirectWrite factory for the glyph atlas.");
+		return nullptr;
+	}
+
+	ComPtr<IDWriteFontCollection> fonts;
+	UINT32 familyIndex = 0;
+	BOOL exists = FALSE;
+	ComPtr<IDWriteFontFamily> fontFamily;
+	ComPtr<IDWriteFont> font;
+	if (FAILED(glyphWriteFactory->GetSystemFontCollection(&fonts)) ||
+		FAILED(fonts->FindFamilyName(family.c_str(), &familyIndex, &exists)) || !exists ||
+		FAILED(fonts->GetFontFamily(familyIndex, &fontFamily)) ||
+		FAILED(fontFamily->GetFirstMatchingFont(DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STRETCH_NORMAL,
+			DWRITE_FONT_STYLE_NORMAL, &font)) ||
+		FAILED(font->CreateFontFace(&face)))
+	{
+		Log("Font [%ls] not found for the glyph atlas.", family.c_str());
+		face.Reset();
+	}
+
+	return face.Get();
+}
+
+bool GlyphRasterizer::GetFontMetrics(const std::wstring& family, float size, FontMetrics& metrics)
+{
+	IDWriteFontFace* face = GetFontFace(family);
+	if (!face) return false;
+
+	DWRITE_FONT_METRICS fontMetrics;
+	face->GetMetrics(&fontMetrics);
+
+	const float scale = size / fontMetrics.designUnitsPerEm;
+	metrics.ascent = fontMetrics.ascent * scale;
+	metrics.descent = fontMetrics.descent * scale;
+	metrics.lineGap = fontMetrics.lineGap * scale;
+	return true;
+}
+
+bool GlyphRasterizer::Rasterize(const std::wstring& family, float size, wchar_t character, GlyphBitmap& bitmap)
+{
+	IDWriteFontFace* face = GetFontFace(family);
+	if (!face) return false;
+
+	//UTF-16 code units are looked up on their own, characters outside the BMP aren't supported.
+	const UINT32 codePoint = character;
+	UINT16 glyphIndex = 0;
+	DWRITE_GLYPH_METRICS glyphMetrics;
+	DWRITE_FONT_METRICS fontMetrics;
+	face->GetMetrics(&fontMetrics);
+	if (FAILED(face->GetGlyphIndices(&codePoint, 1, &glyphIndex)) ||
+		FAILED(face->GetDesignGlyphMetrics(&glyphIndex, 1, &glyphMetrics)))
+	{
+		return false;
+	}
+
+	bitmap.advance = glyphMetrics.advanceWidth * size / fontMetrics.designUnitsPerEm;
+	bitmap.width = bitmap.height = 0;
+	bitmap.alpha.clear();
+
+	const FLOAT glyphAdvance = 0.f;
+	DWRITE_GLYPH_RUN glyphRun = {};
+	glyphRun.fontFace = face;
+	glyphRun.fontEmSize = size;
+	glyphRun.glyphCount = 1;
+	glyphRun.glyphIndices = &glyphIndex;
+	glyphRun.glyphAdvances = &glyphAdvance;
+
+	ComPtr<IDWriteGlyphRunAnalysis> analysis;
+	if (FAILED(glyphWriteFactory->CreateGlyphRunAnalysis(&glyphRun, 1.f, nullptr, DWRITE_RENDERING_MODE_NATURAL,
+		DWRITE_MEASURING_MODE_NATURAL, 0.f, 0.f, &analysis)))
+	{
+		return false;
+	}
+
+	RECT bounds;
+	if (FAILED(analysis->GetAlphaTextureBounds(DWRITE_TEXTURE_CLEARTYPE_3x1, &bounds)))
+	{
+		return false;
+	}
+
+	//Whitespace has an advance but nothing to draw.
+	if (bounds.right <= bounds.left || bounds.bottom <= bounds.top)
+	{
+		return true;
+	}
+
+	bitmap.width = bounds.right - bounds.left;
+	bitmap.height = bounds.bottom - bounds.top;
+	bitmap.offsetX = bounds.left;
+	bitmap.offsetY = bounds.top;
+
+	//Natural rendering only comes as 3x1 ClearType coverage, averaged down to one channel.
+	std::vector<BYTE> clearType((size_t)bitmap.width * bitmap.height * 3);
+	if (FAILED(analysis->CreateAlphaTexture(DWRITE_TEXTURE_CLEARTYPE_3x1, &bounds, clearType.data(), (UINT32)clearType.size())))
+	{
+		return false;
+	}
+
+	bitmap.alpha.resize((size_t)bitmap.width * bitmap.height);
+	for (size_t i = 0; i < bitmap.alpha.size(); i++)
+	{
+		bitmap.alpha[i] = (uint8_t)((clearType[i * 3] + clearType[i * 3 + 1] + clearType[i * 3 + 2]) / 3);
+	}
+
+	return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//Font metrics and single glyph coverage bitmaps from the system's fonts, for GlyphAtlas. Kept apart
+//from the atlas so packing and layout don't depend on the platform's font API.
+namespace GlyphRasterizer
+{
+	struct FontMetrics
+	{
+		float ascent;
+		float descent;
+		float lineGap;
+	};
+
+	struct GlyphBitmap
+	{
+		int width = 0;
+		int height = 0;
+		//Top left of the bitmap from the pen position on the baseline, y down.
+		int offsetX = 0;
+		int offsetY = 0;
+		float advance = 0.f;
+		//One coverage byte per pixel, rows top to bottom.
+		std::vector<uint8_t> alpha;
+	};
+
+	//False if the family isn't installed.
+	bool GetFontMetrics(const std::wstring& family, float size, FontMetrics& metrics);
+
+	//Characters the font has no glyph for come back as its missing glyph.
+	bool Rasterize(const std::wstring& family, float size, wchar_t character, GlyphBitmap& bitmap);
+}
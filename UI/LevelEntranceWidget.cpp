@@ -1,12 +1,18 @@
 #include "vpch.h"
 #include "LevelEntranceWidget.h"
+#include "Gameplay/Game/Profiler.h"
 
 void LevelEntranceWidget::Draw(float deltaTime)
 {
+	PROFILE_FUNCTION();
+	PROFILE_COUNTER("Widgets Drawn", 1);
+
+	static const std::wstring enterPromptText = L"Press 'Enter' to enter level.";
+
 	Layout layout = PercentAlignLayout(0.3f, 0.6f, 0.7f, 0.9f);
 	FillRect(layout);
 	Text(levelName, layout);
 
 	layout.AddVerticalSpace(50.f);
-	Text(L"Press 'Enter' to enter level.", layout);
+	Text(enterPromptText, layout);
 }
@@ -1,9 +1,9 @@
 #pragma once
 
-#include "../Widget.h"
+#include "GameWidget.h"
 
 //Shows level name and details when entering its trigger on the world map.
-class LevelEntranceWidget : public Widget
+class LevelEntranceWidget : public GameWidget
 {
 public:
 	virtual void Draw(float deltaTime) override;
@@ -1,10 +1,17 @@
 #include "vpch.h"
 #include "NoteWidget.h"
+#include "Gameplay/Game/Profiler.h"
 
 void NoteWidget::Draw(float deltaTime)
 {
-	Layout layout = CenterLayoutOnScreenSpaceCoords(175.f, 75.f);
+	PROFILE_FUNCTION();
+	PROFILE_COUNTER("Widgets Drawn", 1);
 
-	FillRect(layout, { 0.5f, 0.5f, 0.5f, 0.5f }, 0.5f);
-	Text(noteText, layout);
+	//Replayed around wherever the note's anchor has moved to on screen.
+	DrawRetained(noteTextBinding.Update(noteTextVersion), [this]() {
+		Layout layout = CenterLayoutOnScreenAnchor(175.f, 75.f);
+
+		FillRect(layout, { 0.5f, 0.5f, 0.5f, 0.5f }, 0.5f);
+		Text(noteText, layout);
+	});
 }
@@ -1,11 +1,22 @@
 #pragma once
 
-#include "../Widget.h"
+#include "GameWidget.h"
+#include "WidgetBinding.h"
 
-class NoteWidget : public Widget
+class NoteWidget : public GameWidget
 {
 public:
 	virtual void Draw(float deltaTime) override;
 
+	//Keeps the text's buffer between pooled reuses.
+	void SetNoteText(const wchar_t* noteText_, int length)
+	{
+		noteText.assign(noteText_, length);
+		noteTextVersion++;
+	}
+
+private:
 	std::wstring noteText;
+	uint32_t noteTextVersion = 0;
+	WidgetBinding<uint32_t> noteTextBinding;
 };
@@ -1,8 +1,12 @@
 #include "vpch.h"
 #include "PhotoWidget.h"
+#include "Gameplay/Game/Profiler.h"
 
 void PhotoWidget::Draw(float deltaTime)
 {
+	PROFILE_FUNCTION();
+	PROFILE_COUNTER("Widgets Drawn", 1);
+
 	Layout layout = PercentAlignLayout(0.1f, 0.5f, 0.3f, 0.7f);
 	Image(photoFilename, layout);
 }
@@ -1,9 +1,9 @@
 #pragma once
 
-#include "../Widget.h"
+#include "GameWidget.h"
 
 //Shows currently taken photo from Player for in-game mechanics.
-class PhotoWidget : public Widget
+class PhotoWidget : public GameWidget
 {
 public:
 	virtual void Draw(float deltaTime) override;
@@ -1,18 +1,24 @@
 #include "vpch.h"
 #include "PlayerActionBarWidget.h"
+#include "Gameplay/Game/Profiler.h"
 
 void PlayerActionBarWidget::Draw(float deltaTime)
 {
-	Layout layout = AlignLayout(150.f, 15.f, Align::Bottom);
-	layout.PushToLeft();
-	layout.rect.right += 20.f;
+	PROFILE_FUNCTION();
+	PROFILE_COUNTER("Widgets Drawn", 1);
 
-	for (int i = 0; i < actionPoints; i++)
-	{
-		layout.AddHorizontalSpace(20.f);
-		FillRect(layout, { 0.f, 0.8f, 0.1f, 1.f }, 0.5f);
+	DrawRetained(actionPointsBinding.Update(actionPoints), [this]() {
+		Layout layout = AlignLayout(150.f, 15.f, Align::Bottom);
+		layout.PushToLeft();
+		layout.rect.right += 20.f;
 
-		//Padding
-		layout.AddHorizontalSpace(5.f);
-	}
+		for (int i = 0; i < actionPoints; i++)
+		{
+			layout.AddHorizontalSpace(20.f);
+			FillRect(layout, { 0.f, 0.8f, 0.1f, 1.f }, 0.5f);
+
+			//Padding
+			layout.AddHorizontalSpace(5.f);
+		}
+	});
 }
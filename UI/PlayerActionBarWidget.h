@@ -1,12 +1,16 @@
 #pragma once
 
-#include "../Widget.h"
+#include "GameWidget.h"
+#include "WidgetBinding.h"
 
 //Shows player action points remaining during combat.
-class PlayerActionBarWidget : public Widget
+class PlayerActionBarWidget : public GameWidget
 {
 public:
 	virtual void Draw(float deltaTime) override;
 
 	int actionPoints = 0;
+
+private:
+	WidgetBinding<int> actionPointsBinding;
 };
@@ -3,32 +3,71 @@
 #include "Salvages/SalvageSystem.h"
 #include "Salvages/SalvageMission.h"
 #include "VString.h"
-#include "Gameplay/GameInstance.h"
+#include "Gameplay/Game/Profiler.h"
 
 void SalvageMissionWidget::Draw(float deltaTime)
 {
-	Layout layout = PercentAlignLayout(0.1f, 0.5f, 0.9f, 0.9f);
+	PROFILE_FUNCTION();
+	PROFILE_COUNTER("Widgets Drawn", 1);
 
-	FillRect(layout);
+	static const std::wstring titleText = L"Salvage Mission Stats";
+	static const std::wstring takenText = L"Taken.";
+	static const std::wstring notTakenText = L"Not yet taken.";
 
-	Text(L"Salvage Mission Stats", layout);
+	//Rows only change when the mission is picked or a photo tag is captured.
+	bool changed = false;
 
-	SalvageMission* currentSalvageMission = SalvageSystem::GetCurrentSalvageMission();
-	std::set<std::string> photoTags = currentSalvageMission->GetAllPhotoTags();
-	for (const std::string& photoTag : photoTags)
+	if (!missionRowsValid)
 	{
-		layout.AddVerticalSpace(30.f);
-		Text(L"Photo: " + VString::stows(photoTag), layout);
+		BuildMissionRows();
+		changed = true;
+	}
+
+	if (capturedTagsVersion.Update(PhotoTags::GetVersion()))
+	{
+		const PhotoTagSet& capturedTags = PhotoTags::GetCaptured();
+		for (size_t i = 0; i < missionPhotoTags.size(); i++)
+		{
+			const PhotoTagID tag = missionPhotoTags[i];
+			missionPhotoTagsTaken[i] = tag != INVALID_PHOTO_TAG && capturedTags.test(tag);
+		}
+		changed = true;
+	}
+
+	DrawRetained(changed, [this]() {
+		Layout layout = PercentAlignLayout(0.1f, 0.5f, 0.9f, 0.9f);
+
+		FillRect(layout);
 
-		layout.AddVerticalSpace(30.f);
-		auto photoTagIt = GameInstance::playerPhotoTagsCaptured.find(photoTag);
-		if (photoTagIt != GameInstance::playerPhotoTagsCaptured.end())
+		Text(titleText, layout);
+
+		for (size_t i = 0; i < missionPhotoTags.size(); i++)
 		{
-			Text(L"Taken.", layout);
+			layout.AddVerticalSpace(30.f);
+			Text(missionPhotoTagLabels[i], layout);
+
+			layout.AddVerticalSpace(30.f);
+			Text(missionPhotoTagsTaken[i] ? takenText : notTakenText, layout);
 		}
-		else
+	});
+}
+
+void SalvageMissionWidget::BuildMissionRows()
+{
+	missionPhotoTags.clear();
+	missionPhotoTagLabels.clear();
+
+	SalvageMission* currentSalvageMission = SalvageSystem::GetCurrentSalvageMission();
+	if (currentSalvageMission)
+	{
+		for (const std::string& photoTag : currentSalvageMission->GetAllPhotoTags())
 		{
-			Text(L"Not yet taken.", layout);
+			missionPhotoTags.push_back(PhotoTags::Intern(photoTag));
+			missionPhotoTagLabels.push_back(L"Photo: " + VString::stows(photoTag));
 		}
 	}
+
+	missionPhotoTagsTaken.assign(missionPhotoTags.size(), false);
+	capturedTagsVersion.Invalidate();
+	missionRowsValid = true;
 }
@@ -1,10 +1,28 @@
 #pragma once
 
-#include "../Widget.h"
+#include "GameWidget.h"
+#include "WidgetBinding.h"
+#include "Gameplay/Game/PhotoTags.h"
 
 //Displays information about a salvage mission that can be undertaken.
-class SalvageMissionWidget : public Widget
+class SalvageMissionWidget : public GameWidget
 {
 public:
 	virtual void Draw(float deltaTime) override;
+
+	//Rows are rebuilt from the current salvage mission on the next Draw. Missions are only picked
+	//in the overworld, so the Player calls this as it opens the widget rather than the widget
+	//reading the mission's tags every frame.
+	void InvalidateMissionRows() { missionRowsValid = false; }
+
+private:
+	void BuildMissionRows();
+
+	bool missionRowsValid = false;
+	std::vector<PhotoTagID> missionPhotoTags;
+	std::vector<std::wstring> missionPhotoTagLabels;
+
+	//Taken state per row, refreshed only when PhotoTags' captured version moves.
+	WidgetBinding<uint32_t> capturedTagsVersion;
+	std::vector<bool> missionPhotoTagsTaken;
 };
@@ -1,15 +1,33 @@
 #include "vpch.h"
 #include "ScanWidget.h"
+#include "Gameplay/Game/Profiler.h"
+#include "Gameplay/Game/WorldWidgets.h"
 
 void ScanWidget::Draw(float deltaTime)
 {
-	Layout layout = PercentAlignLayout(0.3f, 0.65f, 0.7f, 0.95f);
+	PROFILE_FUNCTION();
+	PROFILE_COUNTER("Widgets Drawn", 1);
 
-	FillRect(layout);
-	Text(scanInfoText, layout);
+	DrawRetained(scanInfoBinding.Update(scanInfoVersion), [this]() {
+		Layout layout = PercentAlignLayout(0.3f, 0.65f, 0.7f, 0.95f);
+
+		FillRect(layout);
+		Text(scanInfoText, layout);
+	});
+
+	//Markers follow the camera so aren't retained. Every marker projected in one batch, off screen ones dropped.
+	WorldWidgets::ProjectToScreen(highlightPositions, highlightScreenPositions);
+	for (const XMFLOAT2& screenPosition : highlightScreenPositions)
+	{
+		const float left = std::round(screenPosition.x - 10.f);
+		const float top = std::round(screenPosition.y - 10.f);
+		FillRect(RectLayout({ left, top, left + 20.f, top + 20.f }), { 0.2f, 0.8f, 1.f, 0.5f }, 0.5f);
+	}
 }
 
 void ScanWidget::ResetValues()
 {
 	scanInfoText.clear();
+	scanInfoVersion++;
+	highlightPositions.clear();
 }
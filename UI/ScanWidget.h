@@ -1,17 +1,32 @@
 #pragma once
 
-#include "../Widget.h"
+#include <vector>
+#include "GameWidget.h"
+#include "WidgetBinding.h"
 
-class ScanWidget : public Widget
+class ScanWidget : public GameWidget
 {
 public:
 	virtual void Draw(float deltaTime) override;
 
 	void ResetValues();
 
-	void SetScanInfoText(std::wstring scanInfoText_) { scanInfoText = scanInfoText_; }
-	std::wstring GetScanInfoText() { return scanInfoText; }
+	void SetScanInfoText(const std::wstring& scanInfoText_)
+	{
+		scanInfoText = scanInfoText_;
+		scanInfoVersion++;
+	}
+	const std::wstring& GetScanInfoText() const { return scanInfoText; }
+
+	//World positions of nearby scannables to mark on screen.
+	void SetHighlightPositions(const std::vector<XMFLOAT3>& positions) { highlightPositions = positions; }
 
 private:
 	std::wstring scanInfoText;
+	//Bumped on every change so the binding doesn't compare the whole text each frame.
+	uint32_t scanInfoVersion = 0;
+	WidgetBinding<uint32_t> scanInfoBinding;
+
+	std::vector<XMFLOAT3> highlightPositions;
+	std::vector<XMFLOAT2> highlightScreenPositions;
 };
@@ -0,0 +1,199 @@
+#include "vpch.h"
+#include "SoftwareUIBackend.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include "GlyphAtlas.h"
+#include "Gameplay/Game/DebugCommands.h"
+
+SoftwareUIBackend::SoftwareUIBackend(int width_, int height_) : width(width_), height(height_)
+{
+	pixels.resize((size_t)width * height);
+}
+
+void SoftwareUIBackend::Clear(UIColor color)
+{
+	std::fill(pixels.begin(), pixels.end(), color);
+	batchesDrawn = 0;
+}
+
+void SoftwareUIBackend::Submit(const UIDrawData& data)
+{
+	const UIRect unclipped = { 0.f, 0.f, (float)width, (float)height };
+
+	for (const UIBatch& batch : data.batches)
+	{
+		batchesDrawn++;
+		const UIRect& clip = batch.clip != 0 ? data.clipRects[batch.clip] : unclipped;
+
+		switch (batch.kind)
+		{
+		case UIBatchKind::Quads:
+			for (uint32_t i = 0; i < batch.vertexCount; i += 4)
+			{
+				FillQuad(&data.vertices[batch.firstVertex + i], clip, batch.texture);
+			}
+			break;
+
+		case UIBatchKind::EngineText:
+		case UIBatchKind::EngineImage:
+		{
+			const bool text = batch.kind == UIBatchKind::EngineText;
+			const UIRect& rect = text ? data.engineTexts[batch.engineIndex].rect : data.engineImages[batch.engineIndex].rect;
+			const size_t hash = text ? std::hash<std::wstring>()(data.engineTexts[batch.engineIndex].text) :
+				std::hash<std::string>()(data.engineImages[batch.engineIndex].filename);
+
+			//Half alpha so the stand in also shows up blending in the wrong order.
+			const UIColor standIn = ((UIColor)hash & 0x00FFFFFF) | 0x80000000;
+			const UIVertex quad[4] = {
+				{ rect.left, rect.top, 0.f, 0.f, standIn }, { rect.right, rect.top, 1.f, 0.f, standIn },
+				{ rect.right, rect.bottom, 1.f, 1.f, standIn }, { rect.left, rect.bottom, 0.f, 1.f, standIn } };
+			FillQuad(quad, clip, UI_NO_TEXTURE);
+			break;
+		}
+		}
+	}
+}
+
+void SoftwareUIBackend::FillQuad(const UIVertex* quad, const UIRect& clip, UITextureID texture)
+{
+	//Quads are axis aligned, the first and third vertices are opposite corners.
+	const float left = std::max(quad[0].x, clip.left);
+	const float top = std::max(quad[0].y, clip.top);
+	const float right = std::min(quad[2].x, clip.right);
+	const float bottom = std::min(quad[2].y, clip.bottom);
+
+	//Pixels whose centre is inside [left, right) x [top, bottom).
+	const int x0 = std::max(0, (int)std::ceil(left - 0.5f));
+	const int x1 = std::min(width, (int)std::ceil(right - 0.5f));
+	const int y0 = std::max(0, (int)std::ceil(top - 0.5f));
+	const int y1 = std::min(height, (int)std::ceil(bottom - 0.5f));
+
+	const GlyphAtlas::Page* page = GlyphAtlas::GetPage(texture);
+	if (!page)
+	{
+		for (int y = y0; y < y1; y++)
+		{
+			UIColor* row = &pixels[(size_t)y * width];
+			for (int x = x0; x < x1; x++)
+			{
+				BlendPixel(row[x], quad[0].color);
+			}
+		}
+		return;
+	}
+
+	//Nearest texel at each pixel centre, its coverage scaling the vertex colour's alpha.
+	const float texelsPerPixelX = (quad[2].u - quad[0].u) * GlyphAtlas::pageSize / (quad[2].x - quad[0].x);
+	const float texelsPerPixelY = (quad[2].v - quad[0].v) * GlyphAtlas::pageSize / (quad[2].y - quad[0].y);
+	const uint32_t alpha = quad[0].color >> 24;
+
+	for (int y = y0; y < y1; y++)
+	{
+		UIColor* row = &pixels[(size_t)y * width];
+		const int texelY = std::clamp((int)(quad[0].v * GlyphAtlas::pageSize + (y + 0.5f - quad[0].y) * texelsPerPixelY),
+			0, GlyphAtlas::pageSize - 1);
+		for (int x = x0; x < x1; x++)
+		{
+			const int texelX = std::clamp((int)(quad[0].u * GlyphAtlas::pageSize + (x + 0.5f - quad[0].x) * texelsPerPixelX),
+				0, GlyphAtlas::pageSize - 1);
+			const uint32_t coverage = page->alpha[(size_t)texelY * GlyphAtlas::pageSize + texelX];
+			if (coverage == 0) continue;
+
+			const UIColor texelColor = (quad[0].color & 0x00FFFFFF) | (((alpha * coverage + 127) / 255) << 24);
+			BlendPixel(row[x], texelColor);
+		}
+	}
+}
+
+void SoftwareUIBackend::BlendPixel(UIColor& pixel, UIColor color)
+{
+	const uint32_t alpha = color >> 24;
+	const uint32_t inverse = 255 - alpha;
+
+	UIColor result = 0;
+	for (int shift = 0; shift < 24; shift += 8)
+	{
+		const uint32_t src = (color >> shift) & 0xFF;
+		const uint32_t dst = (pixel >> shift) & 0xFF;
+		result |= ((src * alpha + dst * inverse + 127) / 255) << shift;
+	}
+
+	const uint32_t dstAlpha = pixel >> 24;
+	result |= ((alpha * 255 + dstAlpha * inverse + 127) / 255) << 24;
+	pixel = result;
+}
+
+//Records a HUD shaped frame (enemy health bars, notes, action points, a clipped list, a dialogue
+//box over the top), then draws it batched and in submission order and checks both come out the same
+//with fewer batches than commands.
+static DebugCommands::Registration uiBatchingCommand("UIDrawListBatching", []() {
+	const int width = 1280, height = 720;
+	SoftwareUIBackend backend(width, height);
+
+	UIDrawList::BeginFrame(&backend);
+
+	std::mt19937 random(1234);
+	auto randomFloat = [&random](float max) { return (float)(random() % 10000) / 10000.f * max; };
+
+	for (int i = 0; i < 150; i++)
+	{
+		const float x = randomFloat(width - 100.f), y = randomFloat(height - 50.f);
+		UIDrawList::AddRect({ x, y, x + 100.f, y + 50.f }, MakeUIColor(0.5f, 0.5f, 0.5f, 1.f));
+		UIDrawList::AddEngineText({ x, y, x + 100.f, y + 50.f }, std::to_wstring(i % 10), -1);
+	}
+
+	for (int i = 0; i < 60; i++)
+	{
+		const float x = randomFloat(width - 175.f), y = randomFloat(height - 75.f);
+		UIDrawList::AddRect({ x, y, x + 175.f, y + 75.f }, MakeUIColor(0.5f, 0.5f, 0.5f, 0.25f));
+		UIDrawList::AddEngineText({ x, y, x + 175.f, y + 75.f }, L"Note " + std::to_wstring(i), -1);
+	}
+
+	for (int i = 0; i < 8; i++)
+	{
+		const float x = 565.f + i * 25.f;
+		UIDrawList::AddRect({ x, 690.f, x + 20.f, 705.f }, MakeUIColor(0.f, 0.8f, 0.1f, 0.5f));
+	}
+
+	UIDrawList::SetClipRect({ 100.f, 100.f, 400.f, 300.f });
+	for (int i = 0; i < 20; i++)
+	{
+		const float y = 90.f + i * 12.f;
+		UIDrawList::AddRect({ 80.f, y, 420.f, y + 10.f }, MakeUIColor(0.2f, 0.3f, 0.9f, 0.75f));
+	}
+	UIDrawList::ClearClipRect();
+
+	UIDrawList::AddRect({ 128.f, 432.f, 1152.f, 648.f }, MakeUIColor(0.5f, 0.5f, 0.5f, 1.f));
+	UIDrawList::AddEngineText({ 128.f, 432.f, 1152.f, 648.f }, L"Speaker", -1);
+	UIDrawList::AddEngineText({ 128.f, 462.f, 1152.f, 678.f }, L"Dialogue line", -1);
+
+	const int commandCount = UIDrawList::GetCommandCount();
+
+	backend.Clear(MakeUIColor(0.f, 0.f, 0.f, 1.f));
+	backend.Submit(UIDrawList::Build(false));
+	const std::vector<UIColor> unbatchedPixels = backend.GetPixels();
+
+	backend.Clear(MakeUIColor(0.f, 0.f, 0.f, 1.f));
+	backend.Submit(UIDrawList::Build(true));
+	const int batchCount = backend.GetBatchesDrawn();
+
+	UIDrawList::Reset();
+
+	Log("UI draw list: %d commands in %d batches.", commandCount, batchCount);
+
+	int failureCount = 0;
+	if (backend.GetPixels() != unbatchedPixels)
+	{
+		Log("Batched UI draw list doesn't match drawing in submission order.");
+		failureCount++;
+	}
+	if (batchCount >= commandCount)
+	{
+		Log("UI draw list didn't batch anything.");
+		failureCount++;
+	}
+
+	return failureCount == 0;
+});
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+#include "UIDrawList.h"
+
+//Draws UIDrawList batches into an RGBA image on the CPU, so batching can be checked against
+//unbatched drawing without a GPU or the engine's renderer. Pixel centres inside a quad are
+//covered, blending is straight alpha over and glyph atlas pages are sampled nearest. Engine text
+//and images can't be drawn here, they're filled with a colour made from their string so anything
+//drawn out of order still shows up.
+class SoftwareUIBackend : public UIDrawBackend
+{
+public:
+	SoftwareUIBackend(int width_, int height_);
+
+	void Clear(UIColor color);
+	virtual void Submit(const UIDrawData& data) override;
+
+	const std::vector<UIColor>& GetPixels() const { return pixels; }
+	int GetBatchesDrawn() const { return batchesDrawn; }
+
+private:
+	void FillQuad(const UIVertex* quad, const UIRect& clip, UITextureID texture);
+	void BlendPixel(UIColor& pixel, UIColor color);
+
+	int width;
+	int height;
+	std::vector<UIColor> pixels;
+	int batchesDrawn = 0;
+};
@@ -0,0 +1,511 @@
+#include "vpch.h"
+#include "TextLayoutCache.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <unordered_map>
+#include "Gameplay/Game/DebugCommands.h"
+#include "Gameplay/Game/Profiler.h"
+
+//Assumed to match the engine's widget text format.
+const wchar_t* const defaultTextFontFamily = L"Arial";
+const float defaultTextFontSize = 24.f;
+
+const size_t maxCachedTextLayouts = 2048;
+
+struct CachedTextLayout
+{
+	uint64_t key;
+	std::wstring text;
+	UIFontID font;
+	float width, height;
+	TextLayoutAlign align;
+	uint64_t lastUsed;
+	TextLayout layout;
+};
+
+std::vector<CachedTextLayout> cachedTextLayouts;
+std::unordered_map<uint64_t, uint32_t> cachedTextLayoutIndices;
+uint64_t textLayoutFrame = 0;
+uint64_t textLayoutHits = 0;
+uint64_t textLayoutMisses = 0;
+
+//Scratch for Layout(), kept to save reallocating per call.
+struct TextLayoutLine
+{
+	//Indices into textLayoutWords.
+	uint32_t firstWord, wordCount;
+	float width;
+	bool endsParagraph;
+};
+
+struct TextLayoutWord
+{
+	//Character range in the text.
+	uint32_t first, last;
+	float width;
+};
+
+struct PlacedGlyph
+{
+	TextLayoutGlyph glyph;
+	UITextureID texture;
+};
+
+std::vector<float> textLayoutAdvances;
+std::vector<TextLayoutWord> textLayoutWords;
+std::vector<TextLayoutLine> textLayoutLines;
+std::vector<PlacedGlyph> textLayoutPlaced;
+
+static uint64_t HashTextLayoutKey(const std::wstring& text, UIFontID font, float width, float height, TextLayoutAlign align)
+{
+	//FNV-1a over the text, then the rest of the key.
+	uint64_t hash = 14695981039346656037ull;
+	auto mix = [&hash](const void* data, size_t size) {
+		const uint8_t* bytes = (const uint8_t*)data;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		}
+	};
+
+	mix(text.data(), text.size() * sizeof(wchar_t));
+	mix(&font, sizeof(font));
+	mix(&width, sizeof(width));
+	mix(&height, sizeof(height));
+	mix(&align, sizeof(align));
+	return hash;
+}
+
+static void AddLine(uint32_t firstWord, uint32_t endWord, float spaceAdvance, bool endsParagraph)
+{
+	TextLayoutLine line = { firstWord, endWord - firstWord, 0.f, endsParagraph };
+	for (uint32_t i = firstWord; i < endWord; i++)
+	{
+		line.width += textLayoutWords[i].width;
+	}
+	if (line.wordCount > 1)
+	{
+		line.width += spaceAdvance * (line.wordCount - 1);
+	}
+	textLayoutLines.push_back(line);
+}
+
+//Greedy wrap of one paragraph's words, words wider than a line are broken between characters.
+static void WrapParagraph(float width, float spaceAdvance)
+{
+	uint32_t lineStart = 0;
+	float lineWidth = 0.f;
+
+	for (uint32_t i = 0; i < (uint32_t)textLayoutWords.size(); i++)
+	{
+		TextLayoutWord& word = textLayoutWords[i];
+
+		if (word.width > width && word.last - word.first > 1)
+		{
+			//Split off as much of the word as fits on a line of its own, the rest is wrapped next.
+			if (i > lineStart)
+			{
+				AddLine(lineStart, i, spaceAdvance, false);
+			}
+
+			float pieceWidth = 0.f;
+			uint32_t split = word.first;
+			while (split < word.last - 1 && pieceWidth + textLayoutAdvances[split] <= width)
+			{
+				pieceWidth += textLayoutAdvances[split++];
+			}
+			split = std::max(split, word.first + 1);
+
+			const TextLayoutWord rest = { split, word.last, word.width - pieceWidth };
+			word.last = split;
+			word.width = pieceWidth;
+			textLayoutWords.insert(textLayoutWords.begin() + i + 1, rest);
+
+			AddLine(i, i + 1, spaceAdvance, false);
+			lineStart = i + 1;
+			lineWidth = 0.f;
+			continue;
+		}
+
+		const float widthWithWord = i > lineStart ? lineWidth + spaceAdvance + word.width : word.width;
+		if (i > lineStart && widthWithWord > width)
+		{
+			AddLine(lineStart, i, spaceAdvance, false);
+			lineStart = i;
+			lineWidth = word.width;
+			continue;
+		}
+
+		lineWidth = widthWithWord;
+	}
+
+	AddLine(lineStart, (uint32_t)textLayoutWords.size(), spaceAdvance, true);
+}
+
+void TextLayoutCache::Layout(const std::wstring& text, UIFontID font, float width, float height, TextLayoutAlign align, TextLayout& layout)
+{
+	PROFILE_FUNCTION();
+
+	layout.glyphs.clear();
+	layout.runs.clear();
+	layout.lineCount = 0;
+	layout.height = 0.f;
+
+	const GlyphAtlas::FontMetrics metrics = GlyphAtlas::GetFontMetrics(font);
+	const float spaceAdvance = GlyphAtlas::GetGlyph(font, L' ').advance;
+
+	textLayoutAdvances.resize(text.size());
+	for (size_t i = 0; i < text.size(); i++)
+	{
+		textLayoutAdvances[i] = GlyphAtlas::GetGlyph(font, text[i]).advance;
+	}
+
+	//Words and lines a paragraph at a time, so no line is wrapped across a newline.
+	textLayoutLines.clear();
+	uint32_t paragraphStart = 0;
+	while (paragraphStart <= (uint32_t)text.size())
+	{
+		uint32_t paragraphEnd = paragraphStart;
+		while (paragraphEnd < (uint32_t)text.size() && text[paragraphEnd] != L'\n') paragraphEnd++;
+
+		textLayoutWords.clear();
+		uint32_t i = paragraphStart;
+		while (i < paragraphEnd)
+		{
+			if (text[i] == L' ')
+			{
+				i++;
+				continue;
+			}
+
+			TextLayoutWord word = { i, i, 0.f };
+			while (word.last < paragraphEnd && text[word.last] != L' ')
+			{
+				word.width += textLayoutAdvances[word.last++];
+			}
+			textLayoutWords.push_back(word);
+			i = word.last;
+		}
+
+		//Lines index textLayoutWords, which is refilled per paragraph, so they're placed straight away.
+		const size_t firstLine = textLayoutLines.size();
+		WrapParagraph(width, spaceAdvance);
+
+		for (size_t lineIndex = firstLine; lineIndex < textLayoutLines.size(); lineIndex++)
+		{
+			const TextLayoutLine& line = textLayoutLines[lineIndex];
+			const float baseline = std::round(layout.lineCount * metrics.lineHeight + metrics.ascent);
+			layout.lineCount++;
+
+			float penX = 0.f;
+			float gap = spaceAdvance;
+			switch (align)
+			{
+			case TextLayoutAlign::Leading:
+				break;
+			case TextLayoutAlign::Center:
+				penX = (width - line.width) * 0.5f;
+				break;
+			case TextLayoutAlign::Trailing:
+				penX = width - line.width;
+				break;
+			case TextLayoutAlign::Justified:
+				if (!line.endsParagraph && line.wordCount > 1)
+				{
+					gap += (width - line.width) / (line.wordCount - 1);
+				}
+				break;
+			}
+
+			for (uint32_t w = line.firstWord; w < line.firstWord + line.wordCount; w++)
+			{
+				const TextLayoutWord& word = textLayoutWords[w];
+				for (uint32_t c = word.first; c < word.last; c++)
+				{
+					//Copied, GetGlyph() can move the atlas' glyphs.
+					const GlyphAtlas::Glyph glyph = GlyphAtlas::GetGlyph(font, text[c]);
+					if (glyph.texture != UI_NO_TEXTURE)
+					{
+						//Whole pixels so glyphs sample the atlas texel for texel.
+						const float x = std::round(penX + glyph.offsetX);
+						const float y = baseline + glyph.offsetY;
+						textLayoutPlaced.push_back({ { { x, y, x + glyph.width, y + glyph.height }, glyph.uv }, glyph.texture });
+					}
+					penX += textLayoutAdvances[c];
+				}
+				penX += gap;
+			}
+		}
+
+		paragraphStart = paragraphEnd + 1;
+	}
+
+	layout.height = layout.lineCount * metrics.lineHeight;
+
+	//One run per atlas page, glyphs on the same page keep their order.
+	std::stable_sort(textLayoutPlaced.begin(), textLayoutPlaced.end(),
+		[](const PlacedGlyph& a, const PlacedGlyph& b) { return a.texture < b.texture; });
+
+	layout.glyphs.reserve(textLayoutPlaced.size());
+	for (const PlacedGlyph& placed : textLayoutPlaced)
+	{
+		if (layout.runs.empty() || layout.runs.back().texture != placed.texture)
+		{
+			layout.runs.push_back({ placed.texture, (uint32_t)layout.glyphs.size(), 0 });
+		}
+		layout.runs.back().glyphCount++;
+		layout.glyphs.push_back(placed.glyph);
+	}
+	textLayoutPlaced.clear();
+}
+
+const TextLayout& TextLayoutCache::Get(const std::wstring& text, UIFontID font, float width, float height, TextLayoutAlign align)
+{
+	const uint64_t key = HashTextLayoutKey(text, font, width, height, align);
+	textLayoutFrame++;
+
+	auto indexIt = cachedTextLayoutIndices.find(key);
+	if (indexIt != cachedTextLayoutIndices.end())
+	{
+		CachedTextLayout& cached = cachedTextLayouts[indexIt->second];
+		if (cached.text == text && cached.font == font && cached.width == width && cached.height == height && cached.align == align)
+		{
+			textLayoutHits++;
+			cached.lastUsed = textLayoutFrame;
+			return cached.layout;
+		}
+	}
+
+	PROFILE_COUNTER("Text Layouts Built", 1);
+	textLayoutMisses++;
+
+	//A hash collision reuses the entry it collided with.
+	uint32_t index;
+	if (indexIt != cachedTextLayoutIndices.end())
+	{
+		index = indexIt->second;
+	}
+	else if (cachedTextLayouts.size() < maxCachedTextLayouts)
+	{
+		index = (uint32_t)cachedTextLayouts.size();
+		cachedTextLayouts.emplace_back();
+		cachedTextLayoutIndices.emplace(key, index);
+	}
+	else
+	{
+		index = 0;
+		for (uint32_t i = 1; i < (uint32_t)cachedTextLayouts.size(); i++)
+		{
+			if (cachedTextLayouts[i].lastUsed < cachedTextLayouts[index].lastUsed) index = i;
+		}
+
+		cachedTextLayoutIndices.erase(cachedTextLayouts[index].key);
+		cachedTextLayoutIndices.emplace(key, index);
+	}
+
+	CachedTextLayout& cached = cachedTextLayouts[index];
+	cached.key = key;
+	cached.text = text;
+	cached.font = font;
+	cached.width = width;
+	cached.height = height;
+	cached.align = align;
+	cached.lastUsed = textLayoutFrame;
+	Layout(text, font, width, height, align, cached.layout);
+	return cached.layout;
+}
+
+UIFontID TextLayoutCache::GetDefaultFont()
+{
+	static const UIFontID font = GlyphAtlas::GetFont(defaultTextFontFamily, defaultTextFontSize);
+	return font;
+}
+
+bool TextLayoutCache::Draw(const std::wstring& text, const UIRect& rect, TextLayoutAlign align, UIColor color)
+{
+	const UIFontID font = GetDefaultFont();
+	if (font == INVALID_UI_FONT) return false;
+
+	const TextLayout& layout = Get(text, font, rect.right - rect.left, rect.bottom - rect.top, align);
+
+	for (const TextLayoutRun& run : layout.runs)
+	{
+		const TextLayoutGlyph* glyphs = &layout.glyphs[run.firstGlyph];
+
+		UIRect bounds = glyphs[0].rect;
+		for (uint32_t i = 1; i < run.glyphCount; i++)
+		{
+			bounds.left = std::min(bounds.left, glyphs[i].rect.left);
+			bounds.top = std::min(bounds.top, glyphs[i].rect.top);
+			bounds.right = std::max(bounds.right, glyphs[i].rect.right);
+			bounds.bottom = std::max(bounds.bottom, glyphs[i].rect.bottom);
+		}
+		bounds = { bounds.left + rect.left, bounds.top + rect.top, bounds.right + rect.left, bounds.bottom + rect.top };
+
+		UIVertex* vertices = UIDrawList::AddQuadRun(bounds, run.texture, (int)run.glyphCount);
+		for (uint32_t i = 0; i < run.glyphCount; i++, vertices += 4)
+		{
+			const UIRect& quad = glyphs[i].rect;
+			const UIRect& uv = glyphs[i].uv;
+			const float left = quad.left + rect.left, top = quad.top + rect.top;
+			const float right = quad.right + rect.left, bottom = quad.bottom + rect.top;
+			vertices[0] = { left, top, uv.left, uv.top, color };
+			vertices[1] = { right, top, uv.right, uv.top, color };
+			vertices[2] = { right, bottom, uv.right, uv.bottom, color };
+			vertices[3] = { left, bottom, uv.left, uv.bottom, color };
+		}
+	}
+
+	return true;
+}
+
+uint64_t TextLayoutCache::GetHits()
+{
+	return textLayoutHits;
+}
+
+uint64_t TextLayoutCache::GetMisses()
+{
+	return textLayoutMisses;
+}
+
+int TextLayoutCache::GetCachedCount()
+{
+	return (int)cachedTextLayouts.size();
+}
+
+void TextLayoutCache::Clear()
+{
+	cachedTextLayouts.clear();
+	cachedTextLayoutIndices.clear();
+	textLayoutHits = 0;
+	textLayoutMisses = 0;
+}
+
+//Lays out 10k generated dialogue sized strings uncached, then a frame's worth of them through the
+//cache cold and warm, logging the timings. Also checks justified lines end flush with the rect and
+//that no line runs past it.
+static DebugCommands::Registration textLayoutBenchmark("TextLayoutBenchmark", []() {
+	using BenchmarkClock = std::chrono::steady_clock;
+	auto elapsedMs = [](BenchmarkClock::time_point start) {
+		return std::chrono::duration<double, std::milli>(BenchmarkClock::now() - start).count();
+	};
+
+	const UIFontID font = TextLayoutCache::GetDefaultFont();
+	if (font == INVALID_UI_FONT)
+	{
+		Log("TextLayoutBenchmark: default font isn't installed.");
+		return false;
+	}
+
+	static const wchar_t* const words[] = { L"the", L"salvage", L"ship", L"drifted", L"past", L"a", L"ruined",
+		L"station,", L"its", L"hull", L"scored", L"by", L"years", L"of", L"debris.", L"Captain", L"we're",
+		L"reading", L"life", L"signs", L"aboard!", L"Keep", L"your", L"distance", L"until", L"scans",
+		L"finish", L"uncharacteristically" };
+
+	std::mt19937 random(22);
+	std::vector<std::wstring> strings(10000);
+	for (std::wstring& string : strings)
+	{
+		const int wordCount = 4 + random() % 40;
+		for (int i = 0; i < wordCount; i++)
+		{
+			if (i > 0) string += (random() % 12 == 0) ? L'\n' : L' ';
+			string += words[random() % std::size(words)];
+		}
+	}
+
+	const float width = 600.f, height = 200.f;
+	const TextLayoutAlign aligns[] = { TextLayoutAlign::Leading, TextLayoutAlign::Center,
+		TextLayoutAlign::Trailing, TextLayoutAlign::Justified };
+
+	int failures = 0;
+	size_t glyphCount = 0;
+	TextLayout layout;
+
+	auto start = BenchmarkClock::now();
+	for (size_t i = 0; i < strings.size(); i++)
+	{
+		const TextLayoutAlign align = aligns[i % std::size(aligns)];
+		TextLayoutCache::Layout(strings[i], font, width, height, align, layout);
+		glyphCount += layout.glyphs.size();
+
+		for (const TextLayoutGlyph& glyph : layout.glyphs)
+		{
+			//A glyph's ink can overhang its advance by a pixel or two.
+			if (glyph.rect.right > width + 2.f && failures++ < 5)
+			{
+				Log("TextLayoutBenchmark: string %zu runs past the rect to %.1f.", i, glyph.rect.right);
+			}
+		}
+	}
+	const double uncachedMs = elapsedMs(start);
+
+	//Justified: the last glyph of every line but a paragraph's last ends flush with the right edge.
+	for (size_t i = 0; i < 200; i++)
+	{
+		TextLayoutCache::Layout(strings[i], font, width, height, TextLayoutAlign::Justified, layout);
+
+		std::vector<float> lineRights(layout.lineCount, 0.f);
+		const float lineHeight = layout.lineCount > 0 ? layout.height / layout.lineCount : 1.f;
+		for (const TextLayoutGlyph& glyph : layout.glyphs)
+		{
+			const int line = std::clamp((int)(glyph.rect.bottom / lineHeight - 0.01f), 0, layout.lineCount - 1);
+			lineRights[line] = std::max(lineRights[line], glyph.rect.right);
+		}
+
+		TextLayout leading;
+		TextLayoutCache::Layout(strings[i], font, width, height, TextLayoutAlign::Leading, leading);
+		if (leading.lineCount != layout.lineCount && failures++ < 5)
+		{
+			Log("TextLayoutBenchmark: string %zu wraps differently justified.", i);
+		}
+
+		//Each paragraph's last line isn't stretched.
+		int flushLines = 0;
+		for (int l = 0; l < layout.lineCount; l++)
+		{
+			if (std::abs(lineRights[l] - width) <= 2.f) flushLines++;
+		}
+		const int paragraphs = 1 + (int)std::count(strings[i].begin(), strings[i].end(), L'\n');
+		if (flushLines < layout.lineCount - paragraphs && failures++ < 5)
+		{
+			Log("TextLayoutBenchmark: string %zu has %d of %d justified lines flush.", i, flushLines, layout.lineCount - paragraphs);
+		}
+	}
+
+	//A busy HUD frame's worth of strings, drawn every frame: built once, then all hits.
+	TextLayoutCache::Clear();
+	const size_t frameStrings = 256;
+	start = BenchmarkClock::now();
+	for (size_t i = 0; i < frameStrings; i++)
+	{
+		TextLayoutCache::Get(strings[i], font, width, height, TextLayoutAlign::Justified);
+	}
+	const double coldMs = elapsedMs(start);
+
+	const int warmFrames = 100;
+	start = BenchmarkClock::now();
+	for (int frame = 0; frame < warmFrames; frame++)
+	{
+		for (size_t i = 0; i < frameStrings; i++)
+		{
+			TextLayoutCache::Get(strings[i], font, width, height, TextLayoutAlign::Justified);
+		}
+	}
+	const double warmMs = elapsedMs(start) / warmFrames;
+
+	if (TextLayoutCache::GetMisses() != frameStrings && failures++ < 5)
+	{
+		Log("TextLayoutBenchmark: %llu misses for %zu distinct strings.", (unsigned long long)TextLayoutCache::GetMisses(), frameStrings);
+	}
+
+	Log("TextLayoutBenchmark: %zu strings (%zu glyphs) laid out in %.2f ms, %zu cached cold %.3f ms, warm %.3f ms per frame. "
+		"Atlas: %d glyphs on %d pages.", strings.size(), glyphCount, uncachedMs, frameStrings, coldMs, warmMs,
+		GlyphAtlas::GetGlyphCount(), GlyphAtlas::GetPageCount());
+
+	TextLayoutCache::Clear();
+	return failures == 0;
+});
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "GlyphAtlas.h"
+
+enum class TextLayoutAlign : uint8_t
+{
+	Leading,
+	Center,
+	Trailing,
+	//Every line but a paragraph's last is stretched to the rect's width at its word gaps.
+	Justified,
+};
+
+//A glyph's quad relative to the layout rect's top left.
+struct TextLayoutGlyph
+{
+	UIRect rect;
+	UIRect uv;
+};
+
+//Glyphs from one atlas page, drawn as one quad run.
+struct TextLayoutRun
+{
+	UITextureID texture;
+	uint32_t firstGlyph;
+	uint32_t glyphCount;
+};
+
+struct TextLayout
+{
+	std::vector<TextLayoutGlyph> glyphs;
+	std::vector<TextLayoutRun> runs;
+	int lineCount = 0;
+	float height = 0.f;
+};
+
+//Wraps, aligns and positions text's glyphs from the GlyphAtlas, keeping the result keyed by the
+//string's hash, font, rect size and alignment. A layout only depends on the rect's size, so text in
+//a moving widget keeps hitting the same entry. Least recently used entries are dropped once full.
+namespace TextLayoutCache
+{
+	//Font game widgets' cached text is drawn in, INVALID_UI_FONT if it isn't installed.
+	UIFontID GetDefaultFont();
+
+	//Lays out text without looking in or adding to the cache.
+	void Layout(const std::wstring& text, UIFontID font, float width, float height, TextLayoutAlign align, TextLayout& layout);
+
+	//Valid until the next Get().
+	const TextLayout& Get(const std::wstring& text, UIFontID font, float width, float height, TextLayoutAlign align);
+
+	//Records text's cached layout into UIDrawList at rect. False if there's no font to draw it in.
+	bool Draw(const std::wstring& text, const UIRect& rect, TextLayoutAlign align, UIColor color);
+
+	uint64_t GetHits();
+	uint64_t GetMisses();
+	int GetCachedCount();
+	void Clear();
+}
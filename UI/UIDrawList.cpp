@@ -0,0 +1,300 @@
+#include "vpch.h"
+#include "UIDrawList.h"
+#include <algorithm>
+#include <cmath>
+#include "Gameplay/Game/Profiler.h"
+
+struct UIDrawCommand
+{
+	UIRect bounds;
+	UIBatchKind kind;
+	UITextureID texture;
+	uint16_t clip;
+	//Into uiRecordedVertices for quads, into the draw data's engine calls otherwise.
+	uint32_t firstVertex;
+	uint32_t vertexCount;
+	uint32_t engineIndex;
+	int layer;
+};
+
+std::vector<UIDrawCommand> uiCommands;
+std::vector<UIVertex> uiRecordedVertices;
+UIDrawData uiDrawData;
+
+UIDrawBackend* uiFrameBackend = nullptr;
+uint16_t uiCurrentClip = 0;
+
+//Layering only tests commands that share a bin of a coarse grid over the frame's commands, rather
+//than every earlier command.
+const float uiBinSize = 128.f;
+const int maxUIBinsPerAxis = 32;
+std::vector<std::vector<uint32_t>> uiBins;
+//Last command each command was tested against, so one spanning several shared bins is tested once.
+std::vector<uint32_t> uiTestedBy;
+std::vector<uint32_t> uiCommandOrder;
+
+//The clip rect in use carries over to the commands recorded after a flush.
+static void ClearCommands()
+{
+	const UIRect currentClip = uiCurrentClip != 0 ? uiDrawData.clipRects[uiCurrentClip] : UIRect{};
+
+	uiCommands.clear();
+	uiRecordedVertices.clear();
+	uiDrawData.clipRects.resize(1);
+	uiDrawData.engineTexts.clear();
+	uiDrawData.engineImages.clear();
+
+	if (uiCurrentClip != 0)
+	{
+		uiDrawData.clipRects.push_back(currentClip);
+		uiCurrentClip = 1;
+	}
+}
+
+static UIDrawCommand& AddCommand(const UIRect& bounds, UIBatchKind kind, UITextureID texture)
+{
+	UIDrawCommand command = {};
+	command.bounds = bounds;
+	command.kind = kind;
+	command.texture = texture;
+	command.clip = uiCurrentClip;
+	command.firstVertex = (uint32_t)uiRecordedVertices.size();
+	uiCommands.push_back(command);
+	return uiCommands.back();
+}
+
+static bool SameState(const UIDrawCommand& a, const UIDrawCommand& b)
+{
+	//Engine calls are drawn one at a time, they never join a batch.
+	return a.kind == UIBatchKind::Quads && b.kind == UIBatchKind::Quads &&
+		a.texture == b.texture && a.clip == b.clip;
+}
+
+//Touching counts, antialiased edges can still blend into each other.
+static bool Overlaps(const UIRect& a, const UIRect& b)
+{
+	return a.left <= b.right && b.left <= a.right && a.top <= b.bottom && b.top <= a.bottom;
+}
+
+static void AssignLayers()
+{
+	UIRect extent = uiCommands[0].bounds;
+	for (const UIDrawCommand& command : uiCommands)
+	{
+		extent.left = std::min(extent.left, command.bounds.left);
+		extent.top = std::min(extent.top, command.bounds.top);
+		extent.right = std::max(extent.right, command.bounds.right);
+		extent.bottom = std::max(extent.bottom, command.bounds.bottom);
+	}
+
+	const int binsX = std::clamp((int)std::ceil((extent.right - extent.left) / uiBinSize), 1, maxUIBinsPerAxis);
+	const int binsY = std::clamp((int)std::ceil((extent.bottom - extent.top) / uiBinSize), 1, maxUIBinsPerAxis);
+	const float binWidth = std::max(extent.right - extent.left, 1.f) / binsX;
+	const float binHeight = std::max(extent.bottom - extent.top, 1.f) / binsY;
+
+	uiBins.resize(binsX * binsY);
+	for (std::vector<uint32_t>& bin : uiBins)
+	{
+		bin.clear();
+	}
+	uiTestedBy.assign(uiCommands.size(), UINT32_MAX);
+
+	auto binIndex = [](float value, float origin, float size, int count) {
+		return std::clamp((int)((value - origin) / size), 0, count - 1);
+	};
+
+	for (uint32_t i = 0; i < (uint32_t)uiCommands.size(); i++)
+	{
+		UIDrawCommand& command = uiCommands[i];
+		const int x0 = binIndex(command.bounds.left, extent.left, binWidth, binsX);
+		const int x1 = binIndex(command.bounds.right, extent.left, binWidth, binsX);
+		const int y0 = binIndex(command.bounds.top, extent.top, binHeight, binsY);
+		const int y1 = binIndex(command.bounds.bottom, extent.top, binHeight, binsY);
+
+		int layer = 0;
+		for (int y = y0; y <= y1; y++)
+		{
+			for (int x = x0; x <= x1; x++)
+			{
+				for (uint32_t earlier : uiBins[y * binsX + x])
+				{
+					if (uiTestedBy[earlier] == i) continue;
+					uiTestedBy[earlier] = i;
+
+					const UIDrawCommand& other = uiCommands[earlier];
+					if (!Overlaps(command.bounds, other.bounds)) continue;
+
+					layer = std::max(layer, SameState(command, other) ? other.layer : other.layer + 1);
+				}
+			}
+		}
+		command.layer = layer;
+
+		for (int y = y0; y <= y1; y++)
+		{
+			for (int x = x0; x <= x1; x++)
+			{
+				uiBins[y * binsX + x].push_back(i);
+			}
+		}
+	}
+}
+
+void UIDrawList::BeginFrame(UIDrawBackend* backend)
+{
+	Reset();
+	uiFrameBackend = backend;
+}
+
+void UIDrawList::EndFrame()
+{
+	Flush();
+	Reset();
+}
+
+bool UIDrawList::IsRecording()
+{
+	return uiFrameBackend != nullptr;
+}
+
+void UIDrawList::Flush()
+{
+	if (!uiFrameBackend || uiCommands.empty()) return;
+
+	const UIDrawData& data = Build();
+
+	PROFILE_COUNTER("UI Draw Commands", data.commandCount);
+	PROFILE_COUNTER("UI Draw Calls", (int64_t)data.batches.size());
+
+	uiFrameBackend->Submit(data);
+	ClearCommands();
+}
+
+void UIDrawList::SetClipRect(const UIRect& rect)
+{
+	//Reused so widgets clipping to the same rect still batch together.
+	std::vector<UIRect>& clipRects = uiDrawData.clipRects;
+	if (clipRects.empty()) clipRects.resize(1);
+	for (size_t i = 1; i < clipRects.size(); i++)
+	{
+		const UIRect& clip = clipRects[i];
+		if (clip.left == rect.left && clip.top == rect.top && clip.right == rect.right && clip.bottom == rect.bottom)
+		{
+			uiCurrentClip = (uint16_t)i;
+			return;
+		}
+	}
+
+	clipRects.push_back(rect);
+	uiCurrentClip = (uint16_t)(clipRects.size() - 1);
+}
+
+void UIDrawList::ClearClipRect()
+{
+	uiCurrentClip = 0;
+}
+
+void UIDrawList::AddRect(const UIRect& rect, UIColor color)
+{
+	UIDrawCommand& command = AddCommand(rect, UIBatchKind::Quads, UI_NO_TEXTURE);
+	command.vertexCount = 4;
+
+	uiRecordedVertices.push_back({ rect.left, rect.top, 0.f, 0.f, color });
+	uiRecordedVertices.push_back({ rect.right, rect.top, 1.f, 0.f, color });
+	uiRecordedVertices.push_back({ rect.right, rect.bottom, 1.f, 1.f, color });
+	uiRecordedVertices.push_back({ rect.left, rect.bottom, 0.f, 1.f, color });
+}
+
+UIVertex* UIDrawList::AddQuadRun(const UIRect& bounds, UITextureID texture, int quadCount)
+{
+	UIDrawCommand& command = AddCommand(bounds, UIBatchKind::Quads, texture);
+	command.vertexCount = quadCount * 4;
+
+	uiRecordedVertices.resize(uiRecordedVertices.size() + command.vertexCount);
+	return &uiRecordedVertices[command.firstVertex];
+}
+
+void UIDrawList::AddEngineText(const UIRect& rect, const std::wstring& text, int align)
+{
+	UIDrawCommand& command = AddCommand(rect, UIBatchKind::EngineText, UI_NO_TEXTURE);
+	command.engineIndex = (uint32_t)uiDrawData.engineTexts.size();
+	uiDrawData.engineTexts.push_back({ text, rect, align });
+}
+
+void UIDrawList::AddEngineImage(const UIRect& rect, const std::string& filename)
+{
+	UIDrawCommand& command = AddCommand(rect, UIBatchKind::EngineImage, UI_NO_TEXTURE);
+	command.engineIndex = (uint32_t)uiDrawData.engineImages.size();
+	uiDrawData.engineImages.push_back({ filename, rect });
+}
+
+int UIDrawList::GetCommandCount()
+{
+	return (int)uiCommands.size();
+}
+
+const UIDrawData& UIDrawList::Build(bool sorted)
+{
+	PROFILE_FUNCTION();
+
+	uiDrawData.vertices.clear();
+	uiDrawData.batches.clear();
+	uiDrawData.commandCount = (int)uiCommands.size();
+	if (uiCommands.empty()) return uiDrawData;
+
+	uiCommandOrder.resize(uiCommands.size());
+	for (uint32_t i = 0; i < (uint32_t)uiCommands.size(); i++)
+	{
+		uiCommandOrder[i] = i;
+	}
+
+	if (sorted)
+	{
+		AssignLayers();
+		std::stable_sort(uiCommandOrder.begin(), uiCommandOrder.end(), [](uint32_t a, uint32_t b) {
+			const UIDrawCommand& ca = uiCommands[a];
+			const UIDrawCommand& cb = uiCommands[b];
+			if (ca.layer != cb.layer) return ca.layer < cb.layer;
+			if (ca.kind != cb.kind) return ca.kind < cb.kind;
+			if (ca.texture != cb.texture) return ca.texture < cb.texture;
+			return ca.clip < cb.clip;
+		});
+	}
+
+	uiDrawData.vertices.reserve(uiRecordedVertices.size());
+
+	const UIDrawCommand* previous = nullptr;
+	for (uint32_t index : uiCommandOrder)
+	{
+		const UIDrawCommand& command = uiCommands[index];
+
+		if (sorted && previous && SameState(*previous, command))
+		{
+			uiDrawData.batches.back().vertexCount += command.vertexCount;
+		}
+		else
+		{
+			UIBatch batch;
+			batch.kind = command.kind;
+			batch.texture = command.texture;
+			batch.clip = command.clip;
+			batch.firstVertex = (uint32_t)uiDrawData.vertices.size();
+			batch.vertexCount = command.vertexCount;
+			batch.engineIndex = command.engineIndex;
+			uiDrawData.batches.push_back(batch);
+		}
+
+		uiDrawData.vertices.insert(uiDrawData.vertices.end(), uiRecordedVertices.begin() + command.firstVertex,
+			uiRecordedVertices.begin() + command.firstVertex + command.vertexCount);
+		previous = &command;
+	}
+
+	return uiDrawData;
+}
+
+void UIDrawList::Reset()
+{
+	uiFrameBackend = nullptr;
+	uiCurrentClip = 0;
+	ClearCommands();
+}
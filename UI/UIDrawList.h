@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//Screen space rect in pixels, laid out like D2D1_RECT_F.
+struct UIRect
+{
+	float left, top, right, bottom;
+};
+
+//Straight alpha RGBA, 8 bits per channel, red in the low byte.
+using UIColor = uint32_t;
+
+inline UIColor MakeUIColor(float r, float g, float b, float a)
+{
+	auto channel = [](float value) { return (uint32_t)(value <= 0.f ? 0.f : value >= 1.f ? 255.f : value * 255.f + 0.5f); };
+	return channel(r) | (channel(g) << 8) | (channel(b) << 16) | (channel(a) << 24);
+}
+
+//0 is untextured, the quad is filled with its vertex colour. Otherwise it's a GlyphAtlas page, its
+//alpha scaling the vertex colour's.
+using UITextureID = uint16_t;
+const UITextureID UI_NO_TEXTURE = 0;
+
+//Quads are four vertices, top left then clockwise. UVs are normalised.
+struct UIVertex
+{
+	float x, y;
+	float u, v;
+	UIColor color;
+};
+
+enum class UIBatchKind : uint8_t
+{
+	Quads,
+	//Drawn by the engine's own Widget::Text() and Widget::Image(), in their place in the order.
+	EngineText,
+	EngineImage,
+};
+
+struct UIBatch
+{
+	UIBatchKind kind;
+	UITextureID texture;
+	//Index into UIDrawData::clipRects, 0 is unclipped.
+	uint16_t clip;
+	uint32_t firstVertex;
+	uint32_t vertexCount;
+	//Index into UIDrawData::engineTexts or engineImages.
+	uint32_t engineIndex;
+};
+
+struct UIEngineText
+{
+	std::wstring text;
+	UIRect rect;
+	//The engine's TextAlign, -1 when the call didn't pass one.
+	int align;
+};
+
+struct UIEngineImage
+{
+	std::string filename;
+	UIRect rect;
+};
+
+//One frame's widget drawing as a single vertex stream and the batches that draw it, in order.
+struct UIDrawData
+{
+	std::vector<UIVertex> vertices;
+	std::vector<UIBatch> batches;
+	std::vector<UIRect> clipRects;
+	std::vector<UIEngineText> engineTexts;
+	std::vector<UIEngineImage> engineImages;
+	int commandCount = 0;
+};
+
+class UIDrawBackend
+{
+public:
+	virtual ~UIDrawBackend() = default;
+	virtual void Submit(const UIDrawData& data) = 0;
+};
+
+//Collects every game widget's rects, images and text for the frame instead of drawing them as
+//they're called, then sorts them into as few batches as the draw order allows. Commands are put in
+//layers by overlap: a command goes one layer above any earlier command it overlaps with different
+//state, and in the same layer as earlier overlapping commands with the same state. Sorting by layer
+//then texture and clip keeps every overlapping pair in submission order, so the result looks the
+//same as drawing each call as it was made.
+namespace UIDrawList
+{
+	//Starts recording the frame, to be submitted to backend. Anything drawn while not recording
+	//goes straight to the engine.
+	void BeginFrame(UIDrawBackend* backend);
+	//Submits what's left and stops recording.
+	void EndFrame();
+	bool IsRecording();
+
+	//Submits the commands recorded so far and carries on recording. For engine calls that have to
+	//draw right away, so everything before them is drawn first.
+	void Flush();
+
+	//Applies to the commands added after it.
+	void SetClipRect(const UIRect& rect);
+	void ClearClipRect();
+
+	void AddRect(const UIRect& rect, UIColor color);
+	//A run of textured quads (a line of glyphs) that's one command for layering, with bounds
+	//covering every quad. Returns where to write quadCount * 4 vertices, valid until the next Add.
+	UIVertex* AddQuadRun(const UIRect& bounds, UITextureID texture, int quadCount);
+	void AddEngineText(const UIRect& rect, const std::wstring& text, int align);
+	void AddEngineImage(const UIRect& rect, const std::string& filename);
+
+	int GetCommandCount();
+
+	//Sorts what's been recorded into batches without submitting them. Unsorted keeps one batch per
+	//command in submission order, for checking batching against drawing every call as it came.
+	const UIDrawData& Build(bool sorted = true);
+
+	//Drops what's recorded and stops recording without submitting. Called on level load.
+	void Reset();
+}
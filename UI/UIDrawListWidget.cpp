@@ -0,0 +1,250 @@
+#include "vpch.h"
+#include "UIDrawListWidget.h"
+#include "GlyphAtlas.h"
+#include "UI/UISystem.h"
+#include "Gameplay/Game/Profiler.h"
+
+static D2D1_COLOR_F ToD2DColor(UIColor color)
+{
+	return D2D1::ColorF((color & 0xFF) / 255.f, ((color >> 8) & 0xFF) / 255.f,
+		((color >> 16) & 0xFF) / 255.f, (color >> 24) / 255.f);
+}
+
+UIDrawListWidget::~UIDrawListWidget()
+{
+	//Don't leave the draw list recording for a backend that's gone.
+	UIDrawList::Reset();
+}
+
+void UIDrawListWidget::Draw(float deltaTime)
+{
+	PROFILE_FUNCTION();
+
+	UIDrawList::EndFrame();
+}
+
+void UIDrawListWidget::BeginFrame()
+{
+	//Widgets added to the viewport this frame went in after this one.
+	RemoveFromViewport();
+	AddToViewport();
+
+	UIDrawList::BeginFrame(this);
+}
+
+void UIDrawListWidget::Submit(const UIDrawData& data)
+{
+	PROFILE_FUNCTION();
+
+	CreateDeviceResources();
+
+	ID2D1RenderTarget* renderTarget = UISystem::d2dRenderTarget;
+
+	for (const UIBatch& batch : data.batches)
+	{
+		if (batch.clip != 0)
+		{
+			const UIRect& clip = data.clipRects[batch.clip];
+			renderTarget->PushAxisAlignedClip(D2D1::RectF(clip.left, clip.top, clip.right, clip.bottom),
+				D2D1_ANTIALIAS_MODE_ALIASED);
+		}
+
+		switch (batch.kind)
+		{
+		case UIBatchKind::Quads:
+			DrawQuads(data, batch);
+			break;
+
+		case UIBatchKind::EngineText:
+		{
+			const UIEngineText& text = data.engineTexts[batch.engineIndex];
+			if (text.align < 0)
+			{
+				Widget::Text(text.text, ToLayout(text.rect));
+			}
+			else
+			{
+				Widget::Text(text.text, ToLayout(text.rect), (TextAlign)text.align);
+			}
+			break;
+		}
+
+		case UIBatchKind::EngineImage:
+		{
+			const UIEngineImage& image = data.engineImages[batch.engineIndex];
+			Widget::Image(image.filename, ToLayout(image.rect));
+			break;
+		}
+		}
+
+		if (batch.clip != 0)
+		{
+			renderTarget->PopAxisAlignedClip();
+		}
+	}
+}
+
+void UIDrawListWidget::CreateDeviceResources()
+{
+	if (deviceResourcesCreated) return;
+	deviceResourcesCreated = true;
+
+	UISystem::d2dRenderTarget->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::White), &maskBrush);
+
+	if (FAILED(UISystem::d2dRenderTarget->QueryInterface(IID_PPV_ARGS(&context))))
+	{
+		Log("Direct2D sprite batches unavailable, UI quads will be drawn one at a time.");
+		return;
+	}
+
+	const uint32_t white = 0xFFFFFFFF;
+	const D2D1_BITMAP_PROPERTIES bitmapProperties = D2D1::BitmapProperties(
+		D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED));
+
+	if (FAILED(context->CreateSpriteBatch(&spriteBatch)) ||
+		FAILED(context->CreateBitmap(D2D1::SizeU(1, 1), &white, sizeof(white), bitmapProperties, &whiteBitmap)))
+	{
+		Log("Couldn't create UI sprite batch, UI quads will be drawn one at a time.");
+		context.Reset();
+	}
+}
+
+ID2D1Bitmap* UIDrawListWidget::GetAtlasBitmap(UITextureID texture)
+{
+	const GlyphAtlas::Page* page = GlyphAtlas::GetPage(texture);
+	if (!page) return nullptr;
+
+	if (atlasBitmaps.size() < texture)
+	{
+		atlasBitmaps.resize(texture);
+	}
+
+	AtlasBitmap& atlasBitmap = atlasBitmaps[texture - 1];
+	if (atlasBitmap.bitmap && atlasBitmap.version == page->version)
+	{
+		return atlasBitmap.bitmap.Get();
+	}
+
+	PROFILE_FUNCTION();
+
+	//White, premultiplied by the glyph's coverage, so sprite colours tint it.
+	atlasUploadPixels.resize(page->alpha.size());
+	for (size_t i = 0; i < page->alpha.size(); i++)
+	{
+		atlasUploadPixels[i] = page->alpha[i] * 0x01010101u;
+	}
+
+	const UINT32 pitch = GlyphAtlas::pageSize * sizeof(uint32_t);
+	HRESULT result;
+	if (atlasBitmap.bitmap)
+	{
+		result = atlasBitmap.bitmap->CopyFromMemory(nullptr, atlasUploadPixels.data(), pitch);
+	}
+	else
+	{
+		const D2D1_BITMAP_PROPERTIES bitmapProperties = D2D1::BitmapProperties(
+			D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED));
+		result = UISystem::d2dRenderTarget->CreateBitmap(D2D1::SizeU(GlyphAtlas::pageSize, GlyphAtlas::pageSize),
+			atlasUploadPixels.data(), pitch, bitmapProperties, &atlasBitmap.bitmap);
+	}
+
+	if (FAILED(result))
+	{
+		Log("Couldn't upload glyph atlas page %u.", (unsigned)texture);
+		atlasBitmap.bitmap.Reset();
+		return nullptr;
+	}
+
+	atlasBitmap.version = page->version;
+	return atlasBitmap.bitmap.Get();
+}
+
+void UIDrawListWidget::DrawQuads(const UIDrawData& data, const UIBatch& batch)
+{
+	const UIVertex* vertices = &data.vertices[batch.firstVertex];
+	const uint32_t quadCount = batch.vertexCount / 4;
+
+	ID2D1Bitmap* atlasBitmap = nullptr;
+	if (batch.texture != UI_NO_TEXTURE)
+	{
+		atlasBitmap = GetAtlasBitmap(batch.texture);
+		if (!atlasBitmap) return;
+	}
+
+	//Atlas texel rect a quad's UVs cover.
+	auto sourceRect = [](const UIVertex* quad) {
+		const float size = (float)GlyphAtlas::pageSize;
+		return D2D1::RectU((UINT32)(quad[0].u * size + 0.5f), (UINT32)(quad[0].v * size + 0.5f),
+			(UINT32)(quad[2].u * size + 0.5f), (UINT32)(quad[2].v * size + 0.5f));
+	};
+
+	if (!context)
+	{
+		if (atlasBitmap && !maskBrush) return;
+
+		ID2D1RenderTarget* renderTarget = UISystem::d2dRenderTarget;
+		const D2D1_ANTIALIAS_MODE antialiasMode = renderTarget->GetAntialiasMode();
+		if (atlasBitmap)
+		{
+			//Opacity masks only fill aliased.
+			renderTarget->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+		}
+
+		for (uint32_t i = 0; i < quadCount; i++)
+		{
+			const UIVertex* quad = &vertices[i * 4];
+			if (!atlasBitmap)
+			{
+				Widget::FillRect(ToLayout({ quad[0].x, quad[0].y, quad[2].x, quad[2].y }), ToD2DColor(quad[0].color), 1.f);
+				continue;
+			}
+
+			const D2D1_RECT_U source = sourceRect(quad);
+			maskBrush->SetColor(ToD2DColor(quad[0].color));
+			renderTarget->FillOpacityMask(atlasBitmap, maskBrush.Get(), D2D1_OPACITY_MASK_CONTENT_TEXT_NATURAL,
+				D2D1::RectF(quad[0].x, quad[0].y, quad[2].x, quad[2].y),
+				D2D1::RectF((float)source.left, (float)source.top, (float)source.right, (float)source.bottom));
+		}
+
+		renderTarget->SetAntialiasMode(antialiasMode);
+		return;
+	}
+
+	spriteRects.clear();
+	spriteSourceRects.clear();
+	spriteColors.clear();
+	for (uint32_t i = 0; i < quadCount; i++)
+	{
+		const UIVertex* quad = &vertices[i * 4];
+		spriteRects.push_back(D2D1::RectF(quad[0].x, quad[0].y, quad[2].x, quad[2].y));
+		if (atlasBitmap)
+		{
+			spriteSourceRects.push_back(sourceRect(quad));
+		}
+
+		//Sprite colours multiply the premultiplied bitmap, so they're premultiplied too.
+		D2D1_COLOR_F color = ToD2DColor(quad[0].color);
+		color.r *= color.a;
+		color.g *= color.a;
+		color.b *= color.a;
+		spriteColors.push_back(color);
+	}
+
+	spriteBatch->Clear();
+	spriteBatch->AddSprites(quadCount, spriteRects.data(), atlasBitmap ? spriteSourceRects.data() : nullptr, spriteColors.data());
+
+	//Sprite batches only draw aliased.
+	const D2D1_ANTIALIAS_MODE antialiasMode = context->GetAntialiasMode();
+	context->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+	context->DrawSpriteBatch(spriteBatch.Get(), atlasBitmap ? atlasBitmap : whiteBitmap.Get(),
+		D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR);
+	context->SetAntialiasMode(antialiasMode);
+}
+
+Layout UIDrawListWidget::ToLayout(const UIRect& rect)
+{
+	//Any layout will do, only its rect is drawn with.
+	Layout layout = PercentAlignLayout(0.f, 0.f, 1.f, 1.f);
+	layout.rect = D2D1::RectF(rect.left, rect.top, rect.right, rect.bottom);
+	return layout;
+}
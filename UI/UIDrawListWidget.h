@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include <d2d1_3.h>
+#include <wrl/client.h>
+#include "../Widget.h"
+#include "UIDrawList.h"
+
+//Draws each frame's UIDrawList to the screen. The level driving actor calls BeginFrame() at the end
+//of its Tick, which moves this to the end of the viewport, so every game widget has recorded by the
+//time this draws. Quad batches go out as one Direct2D sprite batch each, glyph atlas pages as
+//bitmaps uploaded again whenever glyphs are added to them. Engine text and images go through
+//Widget's own helpers in their place in the order.
+class UIDrawListWidget : public Widget, public UIDrawBackend
+{
+public:
+	~UIDrawListWidget();
+
+	virtual void Draw(float deltaTime) override;
+	virtual void Submit(const UIDrawData& data) override;
+
+	//Call after anything this frame that adds widgets to the viewport.
+	void BeginFrame();
+
+private:
+	void CreateDeviceResources();
+	void DrawQuads(const UIDrawData& data, const UIBatch& batch);
+	//Null for untextured batches or if the page couldn't be uploaded.
+	ID2D1Bitmap* GetAtlasBitmap(UITextureID texture);
+	Layout ToLayout(const UIRect& rect);
+
+	bool deviceResourcesCreated = false;
+	//Null where ID2D1DeviceContext3 isn't available (before Windows 10 1607), quads are then filled
+	//one at a time.
+	Microsoft::WRL::ComPtr<ID2D1DeviceContext3> context;
+	Microsoft::WRL::ComPtr<ID2D1SpriteBatch> spriteBatch;
+	//Untextured quads are sprites of this tinted by their colour.
+	Microsoft::WRL::ComPtr<ID2D1Bitmap> whiteBitmap;
+	//For filling glyphs one at a time through their atlas page as an opacity mask.
+	Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> maskBrush;
+
+	struct AtlasBitmap
+	{
+		Microsoft::WRL::ComPtr<ID2D1Bitmap> bitmap;
+		uint32_t version = 0;
+	};
+	//Indexed by texture - 1, as GlyphAtlas numbers its pages.
+	std::vector<AtlasBitmap> atlasBitmaps;
+	std::vector<uint32_t> atlasUploadPixels;
+
+	std::vector<D2D1_RECT_F> spriteRects;
+	std::vector<D2D1_RECT_U> spriteSourceRects;
+	std::vector<D2D1_COLOR_F> spriteColors;
+};
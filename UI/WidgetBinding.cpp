@@ -0,0 +1,34 @@
+#include "vpch.h"
+#include "WidgetBinding.h"
+#include "Gameplay/Game/Profiler.h"
+
+uint64_t widgetCacheHits = 0;
+uint64_t widgetCacheRebuilds = 0;
+
+void WidgetCacheStats::RecordHit()
+{
+	widgetCacheHits++;
+	PROFILE_COUNTER("Widget Cache Hits", 1);
+}
+
+void WidgetCacheStats::RecordRebuild()
+{
+	widgetCacheRebuilds++;
+	PROFILE_COUNTER("Widget Cache Rebuilds", 1);
+}
+
+uint64_t WidgetCacheStats::GetHits()
+{
+	return widgetCacheHits;
+}
+
+uint64_t WidgetCacheStats::GetRebuilds()
+{
+	return widgetCacheRebuilds;
+}
+
+void WidgetCacheStats::Reset()
+{
+	widgetCacheHits = 0;
+	widgetCacheRebuilds = 0;
+}
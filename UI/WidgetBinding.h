@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+//Counts how often game widgets replay their retained draw calls against how often they rebuild them,
+//also reported per frame as the "Widget Cache Hits" and "Widget Cache Rebuilds" profiler counters.
+namespace WidgetCacheStats
+{
+	void RecordHit();
+	void RecordRebuild();
+
+	uint64_t GetHits();
+	uint64_t GetRebuilds();
+	void Reset();
+}
+
+//Value a widget's retained draw calls are built from. Widgets call Update() with the current value at
+//the top of Draw() and pass whether it changed to GameWidget::DrawRetained().
+template <typename T>
+class WidgetBinding
+{
+public:
+	bool Update(const T& value)
+	{
+		if (bound && value == cachedValue) return false;
+
+		cachedValue = value;
+		bound = true;
+		return true;
+	}
+
+	void Invalidate() { bound = false; }
+
+private:
+	T cachedValue{};
+	bool bound = false;
+};